@@ -36,6 +36,70 @@
 #include <string>
 #include <source_location>
 #include <map>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <cstdlib>
+#include <cstdint>
+#include <atomic>
+#include <bit>
+#include <tuple>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <cctype>
+#include <cerrno>
+#include <span>
+#include <array>
+#include <concepts>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SOURAVTDD_POSIX 1
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#else
+#define SOURAVTDD_POSIX 0
+#endif
+
+//Stack sampling needs backtrace() and dladdr(), which glibc and macOS have.
+#if SOURAVTDD_POSIX && (defined(__GLIBC__) || defined(__APPLE__))
+#define SOURAVTDD_PROFILER 1
+#include <execinfo.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include <csignal>
+#include <sys/time.h>
+#else
+#define SOURAVTDD_PROFILER 0
+#endif
+
+//Confirms throw on failure unless the compiler has exceptions disabled
+//(-fno-exceptions). In that case a failed CONFIRM records the failure and
+//returns from the current test body instead.
+#ifndef SOURAVTDD_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define SOURAVTDD_EXCEPTIONS 1
+#else
+#define SOURAVTDD_EXCEPTIONS 0
+#endif
+#endif
 
 namespace SouravTDD
 {
@@ -57,10 +121,13 @@ namespace SouravTDD
             virtual ~ConfirmException() = default;
             std::string getReason() const { return mReason; }
             int getLine() const { return mLine; }
+            std::string_view getFile() const { return mFile; }
+            void setFile(std::string_view file) { mFile = file; }
 
         protected:
             std::string mReason;
             int mLine;
+            std::string_view mFile;
     };
 
     class BoolConfirmException : public ConfirmException
@@ -94,8 +161,58 @@ namespace SouravTDD
             std::string_view mActual;
     };
 
+    //Reports where two large values first differ and a window of each
+    //around that point, instead of both values in full.
+    class DifferenceConfirmException : public ConfirmException
+    {
+        public:
+            DifferenceConfirmException(std::string_view summary, std::string_view expected, std::string_view actual, int line) : ConfirmException(line)
+            {
+                mReason = summary;
+                mReason += "\nExpected: ";
+                mReason += expected;
+                mReason += "\nActual:   ";
+                mReason += actual;
+            }
+    };
+
     class Test;
     class TestSuite;
+    class TestBase;
+
+    struct ResourceUsage
+    {
+        long maxRssGrowthKb = 0;
+        long minorFaults = 0;
+        long majorFaults = 0;
+        long voluntarySwitches = 0;
+        long involuntarySwitches = 0;
+        long leakedFds = 0;
+
+        ResourceUsage& operator+=(ResourceUsage const & other)
+        {
+            maxRssGrowthKb += other.maxRssGrowthKb;
+            minorFaults += other.minorFaults;
+            majorFaults += other.majorFaults;
+            voluntarySwitches += other.voluntarySwitches;
+            involuntarySwitches += other.involuntarySwitches;
+            leakedFds += other.leakedFds;
+            return *this;
+        }
+    };
+
+    struct ConfirmFailure
+    {
+        std::string reason;
+        int line;
+        std::string_view file;
+    };
+
+    enum class ConfirmMode
+    {
+        Fatal,
+        Soft
+    };
 
     inline std::map<std::string, std::vector<Test*>>&getTests()
     {
@@ -128,7 +245,298 @@ namespace SouravTDD
         }
         getTestSuites()[name].push_back(suite);
     }
+
+    inline std::map<std::string, std::set<std::string>>& getSuiteDependencies()
+    {
+        static std::map<std::string, std::set<std::string>> dependencies;
+        return dependencies;
+    }
+
+    inline std::map<std::string, std::set<std::string>>& getSuiteResources()
+    {
+        static std::map<std::string, std::set<std::string>> resources;
+        return resources;
+    }
+
+    //The suite runs only after the upstream suite has finished, and is
+    //skipped if the upstream suite's setup failed.
+    class SuiteDependency
+    {
+        public:
+            SuiteDependency(std::string_view suiteName, std::string_view upstreamSuiteName)
+            {
+                getSuiteDependencies()[std::string(suiteName)].insert(std::string(upstreamSuiteName));
+            }
+    };
+
+    //Suites that name the same resource never run at the same time.
+    class SuiteResource
+    {
+        public:
+            SuiteResource(std::string_view suiteName, std::string_view resourceName)
+            {
+                getSuiteResources()[std::string(suiteName)].insert(std::string(resourceName));
+            }
+    };
     
+    enum class FlightEvent : std::uint32_t
+    {
+        RunStart = 1,
+        RunEnd,
+        TestStart,
+        TestEnd,
+        Failure,
+        SuiteSetupStart,
+        SuiteSetupEnd,
+        SuiteTeardownStart,
+        SuiteTeardownEnd
+    };
+
+    //Fixed size so a record never straddles a slot. The sequence is
+    //written last and is 0 while the record is being written.
+    struct FlightRecord
+    {
+        std::uint64_t sequence;
+        std::uint64_t timeNs;
+        std::uint64_t durationNs;
+        std::uint32_t type;
+        std::int32_t value;
+        char text[96];
+    };
+
+    struct FlightHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t capacity;
+        std::uint64_t next;
+        std::int64_t pid;
+        std::int64_t startTimeNs;
+        char reserved[88];
+    };
+
+    inline constexpr char flightMagic[8] = {'S', 'V', 'T', 'D', 'D', 'F', 'R', '1'};
+
+    //Binary event log in a memory mapped ring file. Recording is a few
+    //plain stores into shared file pages with no system call, and the pages
+    //belong to the kernel's page cache, so the log survives the process
+    //being killed. Does nothing until open() succeeds.
+    class FlightRecorder
+    {
+        public:
+            FlightRecorder() : mHeader(nullptr), mRecords(nullptr), mCapacity(0), mSize(0), mFd(-1) {}
+            ~FlightRecorder() { close(); }
+            FlightRecorder(FlightRecorder const &) = delete;
+            FlightRecorder& operator=(FlightRecorder const &) = delete;
+
+            bool open(std::string const & path, std::uint32_t capacity = 4096)
+            {
+                close();
+#if SOURAVTDD_POSIX
+                capacity = std::bit_ceil(capacity < 2 ? 2u : capacity);
+                std::size_t size = sizeof(FlightHeader) + sizeof(FlightRecord) * capacity;
+                int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+                if(fd == -1)
+                {
+                    return false;
+                }
+                //The lock is held until close(), so a second process that
+                //picks the same file fails here instead of truncating the
+                //first one's log.
+                if(flock(fd, LOCK_EX | LOCK_NB) != 0 || ftruncate(fd, 0) != 0 || ftruncate(fd, static_cast<off_t>(size)) != 0)
+                {
+                    ::close(fd);
+                    return false;
+                }
+                void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if(memory == MAP_FAILED)
+                {
+                    ::close(fd);
+                    return false;
+                }
+
+                mFd = fd;
+                mSize = size;
+                mCapacity = capacity;
+                mHeader = static_cast<FlightHeader*>(memory);
+                mRecords = reinterpret_cast<FlightRecord*>(mHeader + 1);
+                std::memcpy(mHeader->magic, flightMagic, sizeof(flightMagic));
+                mHeader->version = 1;
+                mHeader->capacity = capacity;
+                mHeader->next = 0;
+                mHeader->pid = static_cast<std::int64_t>(getpid());
+                mHeader->startTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+                mStart = std::chrono::steady_clock::now();
+                return true;
+#else
+                (void)path;
+                (void)capacity;
+                return false;
+#endif
+            }
+
+            void close()
+            {
+#if SOURAVTDD_POSIX
+                if(mHeader != nullptr)
+                {
+                    munmap(mHeader, mSize);
+                }
+                if(mFd != -1)
+                {
+                    ::close(mFd);
+                }
+#endif
+                mHeader = nullptr;
+                mRecords = nullptr;
+                mFd = -1;
+            }
+
+            bool isOpen() const { return mRecords != nullptr; }
+
+            void record(FlightEvent type, std::string_view text, std::int32_t value = 0, std::uint64_t durationNs = 0)
+            {
+                if(mRecords == nullptr)
+                {
+                    return;
+                }
+                std::uint64_t sequence = std::atomic_ref<std::uint64_t>(mHeader->next).fetch_add(1, std::memory_order_relaxed) + 1;
+                FlightRecord& record = mRecords[(sequence - 1) & (mCapacity - 1)];
+                std::atomic_ref<std::uint64_t> recordSequence(record.sequence);
+                recordSequence.store(0, std::memory_order_relaxed);
+                record.timeNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - mStart).count());
+                record.durationNs = durationNs;
+                record.type = static_cast<std::uint32_t>(type);
+                record.value = value;
+                std::size_t length = text.size() < sizeof(record.text) - 1 ? text.size() : sizeof(record.text) - 1;
+                std::memcpy(record.text, text.data(), length);
+                record.text[length] = '\0';
+                recordSequence.store(sequence, std::memory_order_release);
+            }
+
+        private:
+            FlightHeader* mHeader;
+            FlightRecord* mRecords;
+            std::uint32_t mCapacity;
+            std::size_t mSize;
+            int mFd;
+            std::chrono::steady_clock::time_point mStart;
+    };
+
+    inline FlightRecorder& getFlightRecorder()
+    {
+        static FlightRecorder recorder;
+        return recorder;
+    }
+
+    //Prints the events of a flight recorder file in order, then any test
+    //or suite step that started but never ended.
+    inline bool decodeFlightRecorder(std::string const & path, std::ostream& output)
+    {
+        std::ifstream file(path, std::ios::binary);
+        FlightHeader header{};
+        if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, flightMagic, sizeof(flightMagic)) != 0)
+        {
+            output << "Not a flight recorder file: " << path << "\n";
+            return false;
+        }
+
+        std::vector<FlightRecord> records;
+        FlightRecord record{};
+        for(std::uint32_t i = 0; i < header.capacity && file.read(reinterpret_cast<char*>(&record), sizeof(record)); ++i)
+        {
+            if(record.sequence != 0)
+            {
+                record.text[sizeof(record.text) - 1] = '\0';
+                records.push_back(record);
+            }
+        }
+        std::sort(records.begin(), records.end(), [](FlightRecord const & left, FlightRecord const & right)
+        {
+            return left.sequence < right.sequence;
+        });
+
+        output  << "Flight recorder: pid " << header.pid
+                << ", " << header.next << " events";
+        if(header.next > records.size())
+        {
+            output << ", oldest " << header.next - records.size() << " overwritten";
+        }
+        output << "\n";
+
+        std::map<std::string, FlightRecord> open;
+        char time[32];
+        for(auto const & event : records)
+        {
+            std::snprintf(time, sizeof(time), "[%12.6f s] ", static_cast<double>(event.timeNs) / 1e9);
+            output << time;
+            double milliseconds = static_cast<double>(event.durationNs) / 1e6;
+            std::string text = event.text;
+            switch(static_cast<FlightEvent>(event.type))
+            {
+                case FlightEvent::RunStart:
+                    output << "Run started";
+                    break;
+                case FlightEvent::RunEnd:
+                    output << "Run ended with " << event.value << " failed";
+                    break;
+                case FlightEvent::TestStart:
+                    output << "Test started: " << text;
+                    open["Test " + text] = event;
+                    break;
+                case FlightEvent::TestEnd:
+                    output << (event.value ? "Test passed: " : "Test failed: ") << text << " (" << milliseconds << " ms)";
+                    open.erase("Test " + text);
+                    break;
+                case FlightEvent::Failure:
+                {
+                    //The text is the test name and the reason, split by a newline.
+                    output << "Failure";
+                    std::size_t split = text.find('\n');
+                    if(split != std::string::npos)
+                    {
+                        output << " in " << text.substr(0, split);
+                        text.erase(0, split + 1);
+                    }
+                    if(event.value != -1)
+                    {
+                        output << " on line " << event.value;
+                    }
+                    output << ": " << text;
+                    break;
+                }
+                case FlightEvent::SuiteSetupStart:
+                    output << "Suite setup started: " << text;
+                    open["Setup " + text] = event;
+                    break;
+                case FlightEvent::SuiteSetupEnd:
+                    output << (event.value ? "Suite setup passed: " : "Suite setup failed: ") << text << " (" << milliseconds << " ms)";
+                    open.erase("Setup " + text);
+                    break;
+                case FlightEvent::SuiteTeardownStart:
+                    output << "Suite teardown started: " << text;
+                    open["Teardown " + text] = event;
+                    break;
+                case FlightEvent::SuiteTeardownEnd:
+                    output << (event.value ? "Suite teardown passed: " : "Suite teardown failed: ") << text << " (" << milliseconds << " ms)";
+                    open.erase("Teardown " + text);
+                    break;
+                default:
+                    output << "Unknown event " << event.type;
+                    break;
+            }
+            output << "\n";
+        }
+
+        for(auto const & [name, event] : open)
+        {
+            output << "Never finished: " << name << "\n";
+        }
+        return true;
+    }
+
     class TestBase
     {
         public:
@@ -144,11 +552,55 @@ namespace SouravTDD
             bool passed() const { return mPassed; }
             std::string getReason() const { return mReason; }
             int getConfirmLocation() const { return mConfirmLocation; }
-            void setFailed(std::string reason, int confirmLocation = -1) 
+            std::vector<ConfirmFailure> const & getFailures() const { return mFailures; }
+            std::string const & getOutput() const { return mOutput; }
+            void setOutput(std::string output) { mOutput = std::move(output); }
+            ResourceUsage const & getResourceUsage() const { return mResourceUsage; }
+            void addResourceUsage(ResourceUsage const & usage) { mResourceUsage += usage; }
+            bool isFlaky() const { return mFlaky; }
+            void setFlaky() { mFlaky = true; }
+            //A line printed before the result, such as a benchmark's fit.
+            std::string const & getSummary() const { return mSummary; }
+            void setSummary(std::string summary) { mSummary = std::move(summary); }
+            //Clears the result of a previous run so the test can run again.
+            void reset()
+            {
+                mPassed = true;
+                mReason.clear();
+                mConfirmLocation = -1;
+                mFailures.clear();
+                mOutput.clear();
+                mResourceUsage = ResourceUsage();
+                mFlaky = false;
+            }
+            //Failures accumulate. The reason is every failure reason joined
+            //by newlines and the confirm location is the first failure's line.
+            void setFailed(std::string reason, int confirmLocation = -1, std::string_view file = "") 
             { 
+                if(getFlightRecorder().isOpen())
+                {
+                    std::string event(mSuiteName);
+                    if(!event.empty())
+                    {
+                        event += "/";
+                    }
+                    event += mName;
+                    event += "\n";
+                    event += reason;
+                    getFlightRecorder().record(FlightEvent::Failure, event, confirmLocation);
+                }
+                if(mPassed)
+                {
+                    mReason = reason;
+                    mConfirmLocation = confirmLocation;
+                }
+                else
+                {
+                    mReason += "\n";
+                    mReason += reason;
+                }
                 mPassed = false; 
-                mReason = reason;
-                mConfirmLocation = confirmLocation;
+                mFailures.push_back({std::move(reason), confirmLocation, file});
             }
 
         private:
@@ -157,8 +609,19 @@ namespace SouravTDD
             bool mPassed;
             std::string mReason;
             int mConfirmLocation;
+            std::vector<ConfirmFailure> mFailures;
+            std::string mOutput;
+            ResourceUsage mResourceUsage;
+            bool mFlaky = false;
+            std::string mSummary;
     };
 
+    inline TestBase*& getCurrentTest()
+    {
+        thread_local TestBase* current = nullptr;
+        return current;
+    }
+
     class TestSuite : public TestBase
     {
         public:
@@ -168,6 +631,13 @@ namespace SouravTDD
             }
             virtual void suiteSetup() = 0;
             virtual void suiteTeardown() = 0;
+            //Where a fixture that declares a cache key keeps its built
+            //state. runSuite sets it from the run options before setup.
+            std::string const & getFixtureCacheDir() const { return mFixtureCacheDir; }
+            void setFixtureCacheDir(std::string dir) { mFixtureCacheDir = std::move(dir); }
+
+        private:
+            std::string mFixtureCacheDir;
     };
 
     class Test : public TestBase
@@ -186,6 +656,7 @@ namespace SouravTDD
             std::string mExpectedReason;
     };
 
+#if SOURAVTDD_EXCEPTIONS
     template <typename ExceptionT>
     class TestEx : public Test
     {
@@ -208,254 +679,3113 @@ namespace SouravTDD
         private:
             std::string_view mExceptionName;
     };
+#endif
 
-    inline void runTest(std::ostream& output, Test* test, int& numPassed, int& numFailed, int& numMissedFailed)
+    //Tests are named "suite/test" in the quarantine, history and flight
+    //recorder files, or just "test" when they are not in a suite.
+    inline std::string getQualifiedName(TestBase const * test)
     {
-        output      << "-------Test: "
-                    << test->getName()
-                    << std::endl;
-
-        try
-        {
-            test->runEx();
-        }
-        catch(ConfirmException const & ex)
+        std::string name;
+        if(!test->getSuiteName().empty())
         {
-            test->setFailed(ex.getReason(), ex.getLine());
+            name += test->getSuiteName();
+            name += "/";
         }
-        catch(MissingException const & ex)
+        name += test->getName();
+        return name;
+    }
+
+    //Looks a registered test up by its suite/name. Returns nullptr when
+    //there is no such test.
+    inline Test* findTest(std::string_view qualifiedName)
+    {
+        for(auto const & [key, value] : getTests())
         {
-            std::string message = "Expected exception type ";
-            message += ex.getExType();
-            message += " was not thrown.";
-            test->setFailed(message);
+            for(auto * test : value)
+            {
+                if(getQualifiedName(test) == qualifiedName)
+                {
+                    return test;
+                }
+            }
         }
-        catch(...)
+        return nullptr;
+    }
+
+    //Turns a suite/test name into a file name.
+    inline std::string getFileName(std::string const & qualifiedName)
+    {
+        std::string file = qualifiedName.substr(0, 200);
+        for(char& c : file)
         {
-            test->setFailed("Unexpected exception thrown.");
+            if(!std::isalnum(static_cast<unsigned char>(c)))
+            {
+                c = '_';
+            }
         }
+        return file;
+    }
 
-        if(test->passed())
+    //Creates dir and any missing parents. Returns whether dir exists.
+    inline bool makeDirectories(std::string const & dir)
+    {
+#if SOURAVTDD_POSIX
+        for(std::size_t slash = dir.find('/', 1); ; slash = dir.find('/', slash + 1))
         {
-            if (!test->getExpectedReason().empty())
+            std::string part = dir.substr(0, slash);
+            if(mkdir(part.c_str(), 0755) != 0 && errno != EEXIST)
             {
-                ++numMissedFailed;
-                output << "Missed expected failure\n"
-                    << "Test passed but was expected to fail."
-                    << std::endl;
+                return false;
             }
-            else
+            if(slash == std::string::npos)
             {
-                ++numPassed;
-                output << "PASSED\n";
+                break;
             }
         }
-        else if(!test->getExpectedReason().empty() && test->getReason() == test->getExpectedReason())
-        {
-            ++numPassed;
-            output  << "Expected failure\n"
-                    << test->getExpectedReason()
-                    << std::endl;
-        }
-        else
-        {
-            ++numFailed;
-            if(test->getConfirmLocation() != -1)
-            {
-                output << "FAILED: Confirm failed on line " << test->getConfirmLocation() << "\n";
-            }
-            else
-                output << "FAILED: \n" << test->getReason() << "\n";
+        struct stat info{};
+        return stat(dir.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+#else
+        (void)dir;
+        return false;
+#endif
+    }
+
+    struct RunOptions
+    {
+        //Print captured output for every test, not just failing ones.
+        bool verbose = false;
+        //Redirect stdout and stderr into a per test buffer.
+        bool captureOutput = true;
+        //Print the top resource consumers after the run.
+        bool resourceSummary = false;
+        //Fail a test or suite whose max RSS grows by more than this. 0 means
+        //no budget. Not checked when jobs is more than 1.
+        long maxRssGrowthKb = 0;
+        //Fail a test or suite that leaves file descriptors open. Not checked
+        //when jobs is more than 1.
+        bool failOnFdLeak = false;
+        //Run a failed test again up to this many times. A pass on retry is flaky.
+        int retries = 0;
+        //File listing tests, one per line, whose failures do not fail the run.
+        std::string quarantineFile;
+        //File that keeps run, failure and flaky counts per test across runs.
+        std::string historyFile;
+        //Number of suites that may run at the same time. When this is more
+        //than 1, fds 1 and 2 are shared by the workers, so only output
+        //written through std::cout, std::cerr and std::clog is captured.
+        int jobs = 1;
+        //Randomize the order of suites and of tests within each suite.
+        bool shuffle = false;
+        //Seed for the shuffle. A random seed is picked when none is given.
+        std::uint64_t seed = 0;
+        bool hasSeed = false;
+        //Search the preceding tests for the one that makes a failing test
+        //fail when it passes on its own.
+        bool bisect = false;
+        //Run only the tests named in this file, in the file's order. The
+        //result is whether the last one failed. Bisecting uses this to run
+        //each trial in a fresh process.
+        std::string sequenceFile;
+        //Path of the test program, from argv[0].
+        std::string program;
+        //Memory mapped event log that survives the process being killed.
+        //%n is replaced with the program name. When another process has
+        //the file open, ".<pid>" is added to the name. Empty turns it off.
+        //Decode it with the FlightDecoder tool.
+        std::string flightRecorderFile = "%n_flight.bin";
+        //Directory for a folded stack profile of each test. Empty turns
+        //profiling off. Profiling is off when jobs is more than 1 because
+        //the CPU timer covers the whole process.
+        std::string profileDir;
+        //Directory for cached suite fixtures. Empty rebuilds every fixture.
+        std::string fixtureCacheDir = ".souravtdd_cache";
+    };
 
-            output << test->getReason() << std::endl;
+    inline std::string getFlightRecorderPath(RunOptions const & options)
+    {
+        std::string path = options.flightRecorderFile;
+        std::size_t found = path.find("%n");
+        if(found != std::string::npos)
+        {
+            std::string_view program = options.program;
+            program = program.substr(program.find_last_of("/\\") + 1);
+            path.replace(found, 2, program.empty() ? "souravtdd" : program);
         }
+        return path;
     }
 
-    inline bool runSuite(std::ostream& output, bool setup, std::string const & name, int& numpassed, int& numfailed)
+    inline RunOptions parseRunOptions(int argc, char const * const argv[])
     {
-        for (auto& suite: getTestSuites()[name])
+        RunOptions options;
+        if(argc > 0)
         {
-            if (setup)
+            options.program = argv[0];
+        }
+        for(int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            if(arg == "--verbose")
             {
-                output << "------- Setup";
+                options.verbose = true;
             }
-            else
+            else if(arg == "--no-capture")
             {
-                output << "------- Teardown";
+                options.captureOutput = false;
             }
-
-            output  << suite->getName()
-                    << std::endl;
-            
-            try
+            else if(arg == "--resources")
             {
-                if(setup)
-                {
-                    suite->suiteSetup();
-                }
-                else
-                {
-                    suite->suiteTeardown();
-                }
+                options.resourceSummary = true;
             }
-            catch(ConfirmException const & ex)
+            else if(arg.starts_with("--max-rss-growth="))
             {
-                suite->setFailed(ex.getReason(), ex.getLine());
+                options.maxRssGrowthKb = std::atol(argv[i] + arg.find('=') + 1);
             }
-            catch(...)
+            else if(arg == "--fail-on-fd-leak")
             {
-                suite->setFailed("Unexpected exception thrown.");
+                options.failOnFdLeak = true;
             }
-
-            if(suite->passed())
+            else if(arg == "--retries" && i + 1 < argc)
             {
-                ++numpassed;
-                output << "PASSED\n";
+                options.retries = std::atoi(argv[++i]);
             }
-            else
+            else if(arg.starts_with("--retries="))
             {
-                ++numfailed;
-                if(suite->getConfirmLocation() != -1)
-                {
-                    output << "FAILED: Confirm failed on line " << suite->getConfirmLocation() << "\n";
-                }
-                else
-                output << "FAILED: \n" << suite->getReason() << "\n";
-                return false;
+                options.retries = std::atoi(argv[i] + arg.find('=') + 1);
             }
-        }
-        return true;
-    }
-
-    inline int runTests(std::ostream& output)
-    {
-        output      << "Running "
-                    << getTests().size()
-                    << " tests\n";
-
-        int numPassed = 0;
-        int numFailed = 0;
-        int numMissedFailed = 0;
-
-        for(auto const & [key, value] : getTests())
-        {
-            std::string suiteDisplayName = "Suite: ";
-            if(key.empty())
+            else if(arg.starts_with("--quarantine="))
             {
-                suiteDisplayName += "Single Tests";
+                options.quarantineFile = arg.substr(arg.find('=') + 1);
             }
-            else
+            else if(arg.starts_with("--flaky-history="))
             {
-                suiteDisplayName += key;
+                options.historyFile = arg.substr(arg.find('=') + 1);
             }
-
-            output  << "---------------"
-                    << suiteDisplayName
-                    << std::endl;
-
-            if(!key.empty())
+            else if(arg == "--shuffle")
             {
-                if(!getTestSuites().contains(key))
-                {
-                    output  << "Test suite not found."
-                            << " Exiting test application."
-                            << std::endl;
-
-                    return ++numFailed;
-                }
-
-                if(!runSuite(output, true, key, numPassed, numFailed))
-                {
-                    output  << "Test suite setup failed."
-                            << " Skipping tests in suite."
-                            << std::endl;
-                    continue;
-                }
+                options.shuffle = true;
             }
-
-            for(auto * test : value)
+            else if(arg.starts_with("--shuffle="))
             {
-                runTest(output, test, numPassed, numFailed, numMissedFailed);
+                options.shuffle = true;
+                options.hasSeed = true;
+                options.seed = std::strtoull(argv[i] + arg.find('=') + 1, nullptr, 10);
             }
-
-            if(!key.empty())
+            else if(arg == "--bisect")
             {
-                if(!runSuite(output, false, key, numPassed, numFailed))
-                {
-                    output  << "Test suite teardown failed."
-                            << std::endl;
-                }
+                options.bisect = true;
             }
-        }
-
-        output  << "----------------------------------\n";
-        output  << "Tests passed: " << numPassed
-                << "\nTests failed: " << numFailed;
-        
-        if(numMissedFailed > 0)
-        {
-            output  << "\nTests failures missed: "
-                    << numMissedFailed;
-        }
+            else if(arg.starts_with("--flight-recorder="))
+            {
+                options.flightRecorderFile = arg.substr(arg.find('=') + 1);
+            }
+            else if(arg == "--no-flight-recorder")
+            {
+                options.flightRecorderFile.clear();
+            }
+            else if(arg == "--profile")
+            {
+                options.profileDir = "profiles";
+            }
+            else if(arg.starts_with("--profile="))
+            {
+                options.profileDir = arg.substr(arg.find('=') + 1);
+            }
+            else if(arg.starts_with("--fixture-cache="))
+            {
+                options.fixtureCacheDir = arg.substr(arg.find('=') + 1);
+            }
+            else if(arg == "--no-fixture-cache")
+            {
+                options.fixtureCacheDir.clear();
+            }
+            else if(arg.starts_with("--sequence="))
+            {
+                options.sequenceFile = arg.substr(arg.find('=') + 1);
+            }
+            else if(arg == "--jobs" && i + 1 < argc)
+            {
+                options.jobs = std::atoi(argv[++i]);
+            }
+            else if(arg.starts_with("--jobs="))
+            {
+                options.jobs = std::atoi(argv[i] + arg.find('=') + 1);
+            }
+        }
+        return options;
+    }
+
+    //Stands in for the buffer of a standard stream while suites run in
+    //parallel. Text written by a thread that is capturing goes to that
+    //thread's capture string. Everything else goes to the original buffer.
+    //There is no put area so every write is routed when it is made.
+    class ThreadStreamRouter : public std::streambuf
+    {
+        public:
+            ThreadStreamRouter(std::ostream& stream) : mStream(stream), mOriginal(stream.rdbuf(this))
+            {}
+
+            ~ThreadStreamRouter()
+            {
+                mStream.rdbuf(mOriginal);
+            }
+
+            ThreadStreamRouter(ThreadStreamRouter const &) = delete;
+            ThreadStreamRouter& operator=(ThreadStreamRouter const &) = delete;
+
+            static std::string*& threadCapture()
+            {
+                thread_local std::string* capture = nullptr;
+                return capture;
+            }
+
+        protected:
+            int_type overflow(int_type ch) override
+            {
+                if(traits_type::eq_int_type(ch, traits_type::eof()))
+                {
+                    return traits_type::not_eof(ch);
+                }
+                if(std::string* capture = threadCapture())
+                {
+                    capture->push_back(traits_type::to_char_type(ch));
+                    return ch;
+                }
+                return mOriginal->sputc(traits_type::to_char_type(ch));
+            }
+
+            std::streamsize xsputn(char const * text, std::streamsize count) override
+            {
+                if(std::string* capture = threadCapture())
+                {
+                    capture->append(text, static_cast<std::size_t>(count));
+                    return count;
+                }
+                return mOriginal->sputn(text, count);
+            }
+
+            int sync() override
+            {
+                return threadCapture() != nullptr ? 0 : mOriginal->pubsync();
+            }
+
+        private:
+            std::ostream& mStream;
+            std::streambuf* mOriginal;
+    };
+
+    //Routes std::cout, std::cerr and std::clog per thread for as long as
+    //it lives. Output capture switches to the routed streams meanwhile.
+    class ThreadStreamRouting
+    {
+        public:
+            ThreadStreamRouting() : mOut(std::cout), mErr(std::cerr), mLog(std::clog)
+            {
+                ++installed();
+            }
+
+            ~ThreadStreamRouting()
+            {
+                --installed();
+            }
+
+            ThreadStreamRouting(ThreadStreamRouting const &) = delete;
+            ThreadStreamRouting& operator=(ThreadStreamRouting const &) = delete;
+
+            static bool active()
+            {
+                return installed() > 0;
+            }
+
+        private:
+            static std::atomic<int>& installed()
+            {
+                static std::atomic<int> count = 0;
+                return count;
+            }
+
+            ThreadStreamRouter mOut;
+            ThreadStreamRouter mErr;
+            ThreadStreamRouter mLog;
+    };
+
+    //Points fds 1 and 2 at an in-memory file until finish() is called. A
+    //memfd is used on Linux and an unnamed temporary file elsewhere. Does
+    //nothing on platforms without POSIX file descriptors.
+    //While ThreadStreamRouting is active only this thread's standard
+    //stream output is captured and the fds are left alone.
+    class OutputCapture
+    {
+        public:
+            OutputCapture() : mFile(nullptr), mFd(-1), mSavedOut(-1), mSavedErr(-1), mRouted(false), mPrevious(nullptr)
+            {
+                if(ThreadStreamRouting::active())
+                {
+                    mRouted = true;
+                    mPrevious = ThreadStreamRouter::threadCapture();
+                    ThreadStreamRouter::threadCapture() = &mText;
+                    return;
+                }
+#if SOURAVTDD_POSIX
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+                mFd = memfd_create("souravtdd_output", MFD_CLOEXEC);
+#endif
+                if(mFd == -1)
+                {
+                    mFile = std::tmpfile();
+                    if(mFile == nullptr)
+                    {
+                        return;
+                    }
+                    mFd = fileno(mFile);
+                }
+                flushAll();
+                mSavedOut = dup(STDOUT_FILENO);
+                mSavedErr = dup(STDERR_FILENO);
+                dup2(mFd, STDOUT_FILENO);
+                dup2(mFd, STDERR_FILENO);
+#endif
+            }
+
+            ~OutputCapture()
+            {
+                finish();
+                if(mFile != nullptr)
+                {
+                    std::fclose(mFile);
+                }
+#if SOURAVTDD_POSIX
+                else if(mFd != -1)
+                {
+                    close(mFd);
+                }
+#endif
+            }
+
+            OutputCapture(OutputCapture const &) = delete;
+            OutputCapture& operator=(OutputCapture const &) = delete;
+
+            std::string finish()
+            {
+                std::string captured;
+                if(mRouted)
+                {
+                    ThreadStreamRouter::threadCapture() = mPrevious;
+                    mRouted = false;
+                    captured = std::move(mText);
+                    return captured;
+                }
+#if SOURAVTDD_POSIX
+                if(mSavedOut == -1)
+                {
+                    return captured;
+                }
+                flushAll();
+                dup2(mSavedOut, STDOUT_FILENO);
+                dup2(mSavedErr, STDERR_FILENO);
+                close(mSavedOut);
+                close(mSavedErr);
+                mSavedOut = -1;
+                mSavedErr = -1;
+
+                off_t size = lseek(mFd, 0, SEEK_END);
+                if(size > 0)
+                {
+                    captured.resize(static_cast<std::size_t>(size));
+                    std::size_t total = 0;
+                    while(total < captured.size())
+                    {
+                        ssize_t count = pread(mFd, captured.data() + total, captured.size() - total, static_cast<off_t>(total));
+                        if(count <= 0)
+                        {
+                            break;
+                        }
+                        total += static_cast<std::size_t>(count);
+                    }
+                    captured.resize(total);
+                }
+#endif
+                return captured;
+            }
+
+        private:
+            static void flushAll()
+            {
+                std::cout.flush();
+                std::cerr.flush();
+                std::fflush(stdout);
+                std::fflush(stderr);
+            }
+
+            std::FILE* mFile;
+            int mFd;
+            int mSavedOut;
+            int mSavedErr;
+            bool mRouted;
+            std::string* mPrevious;
+            std::string mText;
+    };
+
+    //Process counters at one point in time. The difference between two
+    //snapshots is the resource usage of whatever ran in between.
+    class ResourceSnapshot
+    {
+        public:
+            ResourceSnapshot()
+            {
+#if SOURAVTDD_POSIX
+                rusage usage{};
+                getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+                //macOS reports max RSS in bytes.
+                mMaxRssKb = usage.ru_maxrss / 1024;
+#else
+                mMaxRssKb = usage.ru_maxrss;
+#endif
+                mMinorFaults = usage.ru_minflt;
+                mMajorFaults = usage.ru_majflt;
+                mVoluntarySwitches = usage.ru_nvcsw;
+                mInvoluntarySwitches = usage.ru_nivcsw;
+                mOpenFds = countOpenFds();
+#endif
+            }
+
+            ResourceUsage since(ResourceSnapshot const & start) const
+            {
+                ResourceUsage usage;
+                usage.maxRssGrowthKb = mMaxRssKb - start.mMaxRssKb;
+                usage.minorFaults = mMinorFaults - start.mMinorFaults;
+                usage.majorFaults = mMajorFaults - start.mMajorFaults;
+                usage.voluntarySwitches = mVoluntarySwitches - start.mVoluntarySwitches;
+                usage.involuntarySwitches = mInvoluntarySwitches - start.mInvoluntarySwitches;
+                usage.leakedFds = mOpenFds - start.mOpenFds;
+                return usage;
+            }
+
+        private:
+#if SOURAVTDD_POSIX
+            static long countOpenFds()
+            {
+#if defined(__linux__)
+                DIR* dir = opendir("/proc/self/fd");
+#else
+                DIR* dir = opendir("/dev/fd");
+#endif
+                if(dir == nullptr)
+                {
+                    return 0;
+                }
+                //The directory's own fd is counted in every snapshot so it cancels out.
+                long count = 0;
+                while(dirent* entry = readdir(dir))
+                {
+                    if(entry->d_name[0] != '.')
+                    {
+                        ++count;
+                    }
+                }
+                closedir(dir);
+                return count;
+            }
+#endif
+
+            long mMaxRssKb = 0;
+            long mMinorFaults = 0;
+            long mMajorFaults = 0;
+            long mVoluntarySwitches = 0;
+            long mInvoluntarySwitches = 0;
+            long mOpenFds = 0;
+    };
+
+    inline void checkResourceBudget(TestBase* test, ResourceUsage const & usage, RunOptions const & options)
+    {
+        if(options.failOnFdLeak && usage.leakedFds > 0)
+        {
+            test->setFailed("Leaked " + std::to_string(usage.leakedFds) + " file descriptors.");
+        }
+        if(options.maxRssGrowthKb > 0 && usage.maxRssGrowthKb > options.maxRssGrowthKb)
+        {
+            test->setFailed("Max RSS grew by " + std::to_string(usage.maxRssGrowthKb)
+                + " KB. The budget is " + std::to_string(options.maxRssGrowthKb) + " KB.");
+        }
+    }
+
+    inline void reportResourceUsage(std::ostream& output, TestBase const * test)
+    {
+        ResourceUsage const & usage = test->getResourceUsage();
+        output  << test->getName()
+                << ": RSS +" << usage.maxRssGrowthKb << " KB"
+                << ", page faults " << usage.minorFaults << " minor " << usage.majorFaults << " major"
+                << ", context switches " << usage.voluntarySwitches << " voluntary " << usage.involuntarySwitches << " involuntary";
+        if(usage.leakedFds > 0)
+        {
+            output << ", leaked fds " << usage.leakedFds;
+        }
+        output << "\n";
+    }
+
+    //Lists the tests and suites with the largest RSS growth, then page
+    //faults, and every one that leaked file descriptors.
+    inline void reportResourceSummary(std::ostream& output, std::size_t count = 5)
+    {
+        std::vector<TestBase const *> all;
+        for(auto const & [key, value] : getTestSuites())
+        {
+            all.insert(all.end(), value.begin(), value.end());
+        }
+        for(auto const & [key, value] : getTests())
+        {
+            all.insert(all.end(), value.begin(), value.end());
+        }
+
+        std::sort(all.begin(), all.end(), [](TestBase const * left, TestBase const * right)
+        {
+            ResourceUsage const & l = left->getResourceUsage();
+            ResourceUsage const & r = right->getResourceUsage();
+            if(l.maxRssGrowthKb != r.maxRssGrowthKb)
+            {
+                return l.maxRssGrowthKb > r.maxRssGrowthKb;
+            }
+            return l.minorFaults + l.majorFaults > r.minorFaults + r.majorFaults;
+        });
+
+        output << "----------------------------------\n";
+        output << "Top resource consumers:\n";
+        for(std::size_t i = 0; i < all.size() && i < count; ++i)
+        {
+            reportResourceUsage(output, all[i]);
+        }
+
+        bool headerPrinted = false;
+        for(auto const * test : all)
+        {
+            if(test->getResourceUsage().leakedFds > 0)
+            {
+                if(!headerPrinted)
+                {
+                    output << "File descriptor leaks:\n";
+                    headerPrinted = true;
+                }
+                reportResourceUsage(output, test);
+            }
+        }
+    }
+
+    inline void reportOutput(std::ostream& output, TestBase const * test)
+    {
+        if(test->getOutput().empty())
+        {
+            return;
+        }
+        output << "Captured output:\n" << test->getOutput();
+        if(test->getOutput().back() != '\n')
+        {
+            output << "\n";
+        }
+    }
+
+    inline void reportFailures(std::ostream& output, TestBase const * test)
+    {
+        for(auto const & failure : test->getFailures())
+        {
+            if(failure.line != -1)
+            {
+                output << "FAILED: Confirm failed on line " << failure.line;
+                if(!failure.file.empty())
+                {
+                    output << " in " << failure.file;
+                }
+                output << "\n";
+            }
+            else
+                output << "FAILED: \n";
+
+            output << failure.reason << "\n";
+        }
+    }
+
+    //Samples the call stack on the process CPU timer (SIGPROF) while it is
+    //running. The signal handler only calls backtrace() into slots that
+    //were allocated up front, so it never allocates or takes a lock. Frames
+    //are turned into names after stop(). Only one profiler can run at a
+    //time. Does nothing on platforms without backtrace().
+    class SamplingProfiler
+    {
+        public:
+            SamplingProfiler(std::size_t capacity = 10000, std::size_t maxDepth = 64)
+                : mFrames(capacity * maxDepth), mDepths(capacity), mCapacity(capacity), mMaxDepth(maxDepth), mCount(0) {}
+            ~SamplingProfiler() { stop(); }
+            SamplingProfiler(SamplingProfiler const &) = delete;
+            SamplingProfiler& operator=(SamplingProfiler const &) = delete;
+
+            bool start(long intervalUs = 1000)
+            {
+#if SOURAVTDD_PROFILER
+                SamplingProfiler* expected = nullptr;
+                if(!active().compare_exchange_strong(expected, this))
+                {
+                    return false;
+                }
+                mCount.store(0);
+
+                //The first backtrace() call can load libgcc, which is not
+                //safe inside a signal handler.
+                void* warmup[2];
+                backtrace(warmup, 2);
+
+                //The handler stays installed after stop() so that a signal
+                //still in flight is ignored rather than killing the process.
+                static bool installed = false;
+                if(!installed)
+                {
+                    struct sigaction action{};
+                    action.sa_handler = &SamplingProfiler::onSignal;
+                    action.sa_flags = SA_RESTART;
+                    sigemptyset(&action.sa_mask);
+                    sigaction(SIGPROF, &action, nullptr);
+                    installed = true;
+                }
+
+                itimerval timer{};
+                timer.it_interval.tv_sec = intervalUs / 1000000;
+                timer.it_interval.tv_usec = intervalUs % 1000000;
+                timer.it_value = timer.it_interval;
+                setitimer(ITIMER_PROF, &timer, nullptr);
+                return true;
+#else
+                (void)intervalUs;
+                return false;
+#endif
+            }
+
+            void stop()
+            {
+#if SOURAVTDD_PROFILER
+                if(active().load() != this)
+                {
+                    return;
+                }
+                itimerval timer{};
+                setitimer(ITIMER_PROF, &timer, nullptr);
+                active().store(nullptr);
+#endif
+            }
+
+            static bool running()
+            {
+                return active().load() != nullptr;
+            }
+
+            std::size_t sampleCount() const
+            {
+                return std::min(mCount.load(), mCapacity);
+            }
+
+            std::size_t droppedCount() const
+            {
+                std::size_t count = mCount.load();
+                return count > mCapacity ? count - mCapacity : 0;
+            }
+
+            //Stacks in the folded format that flame graph tools read: the
+            //frames from the outermost call to the sampled one joined with
+            //';', mapped to the number of samples with that stack.
+            std::map<std::string, std::size_t> foldedStacks() const
+            {
+                std::map<std::string, std::size_t> stacks;
+#if SOURAVTDD_PROFILER
+                std::map<void*, std::string> names;
+                for(std::size_t sample = 0; sample < sampleCount(); ++sample)
+                {
+                    void* const * frames = mFrames.data() + sample * mMaxDepth;
+                    std::string stack;
+                    //Frame 0 is the signal handler and frame 1 the signal
+                    //trampoline. Frame 2 is where the timer went off.
+                    for(int frame = mDepths[sample] - 1; frame >= 2; --frame)
+                    {
+                        //Outer frames hold return addresses, which can point
+                        //just past the end of the calling function.
+                        char* address = static_cast<char*>(frames[frame]);
+                        if(frame > 2)
+                        {
+                            --address;
+                        }
+                        auto [name, inserted] = names.try_emplace(address);
+                        if(inserted)
+                        {
+                            name->second = symbolize(address);
+                        }
+                        if(!stack.empty())
+                        {
+                            stack += ';';
+                        }
+                        stack += name->second;
+                    }
+                    if(!stack.empty())
+                    {
+                        ++stacks[stack];
+                    }
+                }
+#endif
+                return stacks;
+            }
+
+            bool writeFolded(std::string const & path) const
+            {
+                std::ofstream file(path);
+                if(!file)
+                {
+                    return false;
+                }
+                for(auto const & [stack, count] : foldedStacks())
+                {
+                    file << stack << " " << count << "\n";
+                }
+                return static_cast<bool>(file);
+            }
+
+        private:
+            static std::atomic<SamplingProfiler*>& active()
+            {
+                static std::atomic<SamplingProfiler*> profiler{nullptr};
+                return profiler;
+            }
+
+#if SOURAVTDD_PROFILER
+            static void onSignal(int)
+            {
+                SamplingProfiler* profiler = active().load();
+                if(profiler == nullptr)
+                {
+                    return;
+                }
+                int savedErrno = errno;
+                std::size_t sample = profiler->mCount.fetch_add(1);
+                if(sample < profiler->mCapacity)
+                {
+                    profiler->mDepths[sample] = backtrace(profiler->mFrames.data() + sample * profiler->mMaxDepth,
+                        static_cast<int>(profiler->mMaxDepth));
+                }
+                errno = savedErrno;
+            }
+
+            //Uses the dynamic symbol table, so functions in an executable
+            //only get names when it is linked with -rdynamic. Others are
+            //shown as module+offset.
+            static std::string symbolize(void* address)
+            {
+                Dl_info info{};
+                if(dladdr(address, &info) == 0)
+                {
+                    std::ostringstream name;
+                    name << address;
+                    return name.str();
+                }
+                if(info.dli_sname != nullptr)
+                {
+                    int status = 0;
+                    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                    std::string name = status == 0 ? demangled : info.dli_sname;
+                    std::free(demangled);
+                    return name;
+                }
+                std::string_view module = info.dli_fname != nullptr ? info.dli_fname : "";
+                module = module.substr(module.find_last_of('/') + 1);
+                std::ostringstream name;
+                name << module << "+0x" << std::hex
+                     << static_cast<char*>(address) - static_cast<char*>(info.dli_fbase);
+                return name.str();
+            }
+#endif
+
+            std::vector<void*> mFrames;
+            std::vector<int> mDepths;
+            std::size_t mCapacity;
+            std::size_t mMaxDepth;
+            std::atomic<std::size_t> mCount;
+    };
+
+    inline SamplingProfiler& getProfiler()
+    {
+        static SamplingProfiler profiler;
+        return profiler;
+    }
+
+    inline void runTest(std::ostream& output, Test* test, int& numPassed, int& numFailed, int& numMissedFailed, RunOptions const & options = RunOptions())
+    {
+        output      << "-------Test: "
+                    << test->getName()
+                    << std::endl;
+
+        std::string qualifiedName = getQualifiedName(test);
+        int failedBefore = numFailed;
+        int missedFailedBefore = numMissedFailed;
+        auto started = std::chrono::steady_clock::now();
+        getFlightRecorder().record(FlightEvent::TestStart, qualifiedName);
+
+        std::unique_ptr<OutputCapture> capture;
+        if(options.captureOutput)
+        {
+            capture = std::make_unique<OutputCapture>();
+        }
+
+        ResourceSnapshot startUsage;
+        bool profiling = !options.profileDir.empty() && getProfiler().start();
+        //Restored rather than cleared so a test can run other tests.
+        TestBase* previous = getCurrentTest();
+        getCurrentTest() = test;
+#if SOURAVTDD_EXCEPTIONS
+        try
+        {
+#endif
+            test->runEx();
+#if SOURAVTDD_EXCEPTIONS
+        }
+        catch(ConfirmException const & ex)
+        {
+            test->setFailed(ex.getReason(), ex.getLine(), ex.getFile());
+        }
+        catch(MissingException const & ex)
+        {
+            std::string message = "Expected exception type ";
+            message += ex.getExType();
+            message += " was not thrown.";
+            test->setFailed(message);
+        }
+        catch(...)
+        {
+            test->setFailed("Unexpected exception thrown.");
+        }
+#endif
+        getCurrentTest() = previous;
+        if(profiling)
+        {
+            getProfiler().stop();
+        }
+        ResourceUsage usage = ResourceSnapshot().since(startUsage);
+        test->addResourceUsage(usage);
+        checkResourceBudget(test, usage, options);
+
+        if(capture)
+        {
+            test->setOutput(capture->finish());
+        }
+
+        if(!test->getSummary().empty())
+        {
+            output << test->getSummary() << "\n";
+        }
+
+        if(profiling && getProfiler().sampleCount() > 0)
+        {
+            std::string path = options.profileDir + "/" + getFileName(qualifiedName) + ".folded";
+            if(getProfiler().writeFolded(path))
+            {
+                output << "Profile: " << path << " (" << getProfiler().sampleCount() << " samples)\n";
+            }
+            else
+            {
+                output << "Cannot write profile: " << path << "\n";
+            }
+        }
+
+        if(test->passed())
+        {
+            if (!test->getExpectedReason().empty())
+            {
+                ++numMissedFailed;
+                output << "Missed expected failure\n"
+                    << "Test passed but was expected to fail."
+                    << std::endl;
+            }
+            else
+            {
+                ++numPassed;
+                output << "PASSED\n";
+            }
+        }
+        else if(!test->getExpectedReason().empty() && test->getReason() == test->getExpectedReason())
+        {
+            ++numPassed;
+            output  << "Expected failure\n"
+                    << test->getExpectedReason()
+                    << std::endl;
+        }
+        else
+        {
+            ++numFailed;
+            reportFailures(output, test);
+            reportOutput(output, test);
+            output << std::flush;
+        }
+
+        if(options.verbose && numFailed == failedBefore)
+        {
+            reportOutput(output, test);
+        }
+
+        bool counted = numFailed == failedBefore && numMissedFailed == missedFailedBefore;
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started);
+        getFlightRecorder().record(FlightEvent::TestEnd, qualifiedName, counted ? 1 : 0, static_cast<std::uint64_t>(duration.count()));
+    }
+
+    inline bool runSuite(std::ostream& output, bool setup, std::string const & name, int& numpassed, int& numfailed, RunOptions const & options = RunOptions())
+    {
+        for (auto& suite: getTestSuites().at(name))
+        {
+            if (setup)
+            {
+                output << "------- Setup";
+            }
+            else
+            {
+                output << "------- Teardown";
+            }
+
+            output  << suite->getName()
+                    << std::endl;
+            
+            std::string qualifiedName = getQualifiedName(suite);
+            auto started = std::chrono::steady_clock::now();
+            getFlightRecorder().record(setup ? FlightEvent::SuiteSetupStart : FlightEvent::SuiteTeardownStart, qualifiedName);
+            ResourceSnapshot startUsage;
+            if(setup)
+            {
+                suite->setFixtureCacheDir(options.fixtureCacheDir);
+                suite->setSummary("");
+            }
+            TestBase* previous = getCurrentTest();
+            getCurrentTest() = suite;
+#if SOURAVTDD_EXCEPTIONS
+            try
+            {
+#endif
+                if(setup)
+                {
+                    suite->suiteSetup();
+                }
+                else
+                {
+                    suite->suiteTeardown();
+                }
+#if SOURAVTDD_EXCEPTIONS
+            }
+            catch(ConfirmException const & ex)
+            {
+                suite->setFailed(ex.getReason(), ex.getLine(), ex.getFile());
+            }
+            catch(...)
+            {
+                suite->setFailed("Unexpected exception thrown.");
+            }
+#endif
+            getCurrentTest() = previous;
+            //Setup and teardown add up so a descriptor opened in setup and
+            //closed in teardown is not a leak.
+            suite->addResourceUsage(ResourceSnapshot().since(startUsage));
+            if(!setup)
+            {
+                checkResourceBudget(suite, suite->getResourceUsage(), options);
+            }
+            auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started);
+            getFlightRecorder().record(setup ? FlightEvent::SuiteSetupEnd : FlightEvent::SuiteTeardownEnd, qualifiedName,
+                suite->passed() ? 1 : 0, static_cast<std::uint64_t>(duration.count()));
+
+            if(setup && !suite->getSummary().empty())
+            {
+                output << suite->getSummary() << "\n";
+            }
+
+            if(suite->passed())
+            {
+                ++numpassed;
+                output << "PASSED\n";
+            }
+            else
+            {
+                ++numfailed;
+                reportFailures(output, suite);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline std::set<std::string> loadQuarantine(std::string const & path)
+    {
+        std::set<std::string> names;
+        std::ifstream file(path);
+        std::string line;
+        while(std::getline(file, line))
+        {
+            if(!line.empty() && line[0] != '#')
+            {
+                names.insert(line);
+            }
+        }
+        return names;
+    }
+
+    struct FlakyRecord
+    {
+        int runs = 0;
+        int failures = 0;
+        int flaky = 0;
+    };
+
+    //One test per line: runs, failures and flaky counts then the name,
+    //separated by tabs.
+    inline std::map<std::string, FlakyRecord> loadFlakyHistory(std::string const & path)
+    {
+        std::map<std::string, FlakyRecord> history;
+        std::ifstream file(path);
+        std::string line;
+        while(std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            FlakyRecord record;
+            std::string name;
+            if(fields >> record.runs >> record.failures >> record.flaky && fields.get() == '\t' && std::getline(fields, name))
+            {
+                history[name] = record;
+            }
+        }
+        return history;
+    }
+
+    inline void saveFlakyHistory(std::string const & path, std::map<std::string, FlakyRecord> const & history)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        for(auto const & [name, record] : history)
+        {
+            file << record.runs << '\t' << record.failures << '\t' << record.flaky << '\t' << name << '\n';
+        }
+    }
+
+    //Runs each failed test again on its own, with a fresh setup and
+    //teardown of its suite. A test that passes is flaky. It is taken off
+    //the failed list and stops counting as a failure.
+    inline void retryTests(std::ostream& output, std::string const & suiteName, std::vector<Test*>& failed, int& numFailed, int& numFlaky, RunOptions const & options)
+    {
+        auto suites = getTestSuites().find(suiteName);
+        if(suites != getTestSuites().end())
+        {
+            for(auto const * suite : suites->second)
+            {
+                if(!suite->passed())
+                {
+                    return;
+                }
+            }
+        }
+
+        for(auto it = failed.begin(); it != failed.end();)
+        {
+            Test* test = *it;
+            bool flaky = false;
+            for(int attempt = 1; attempt <= options.retries && !flaky; ++attempt)
+            {
+                output  << "-------Retry " << attempt << ": "
+                        << test->getName()
+                        << std::endl;
+
+                int retryPassed = 0;
+                int retryFailed = 0;
+                int retryMissedFailed = 0;
+                if(!suiteName.empty() && !runSuite(output, true, suiteName, retryPassed, retryFailed, options))
+                {
+                    output  << "Test suite setup failed."
+                            << " Stopping retries."
+                            << std::endl;
+                    return;
+                }
+
+                test->reset();
+                runTest(output, test, retryPassed, retryFailed, retryMissedFailed, options);
+                flaky = retryFailed == 0 && retryMissedFailed == 0;
+
+                if(!suiteName.empty())
+                {
+                    runSuite(output, false, suiteName, retryPassed, retryFailed, options);
+                }
+            }
+
+            if(flaky)
+            {
+                output << "FLAKY: Passed on retry\n";
+                test->setFlaky();
+                --numFailed;
+                ++numFlaky;
+                it = failed.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    //Fisher-Yates with a fixed generator and no distribution so a seed
+    //gives the same order with every standard library.
+    template <typename T>
+    void shuffleOrder(std::vector<T>& items, std::uint64_t seed)
+    {
+        std::mt19937_64 generator(seed);
+        for(std::size_t i = items.size(); i > 1; --i)
+        {
+            std::size_t j = static_cast<std::size_t>(generator() % i);
+            std::swap(items[i - 1], items[j]);
+        }
+    }
+
+    struct RunCounts
+    {
+        int passed = 0;
+        int failed = 0;
+        int missedFailed = 0;
+        int flaky = 0;
+        int quarantined = 0;
+
+        RunCounts& operator+=(RunCounts const & other)
+        {
+            passed += other.passed;
+            failed += other.failed;
+            missedFailed += other.missedFailed;
+            flaky += other.flaky;
+            quarantined += other.quarantined;
+            return *this;
+        }
+    };
+
+    //Runs the tests of one suite between its setup and teardown, then
+    //retries and quarantines failures. Tests still failing at the end are
+    //left in failed. Returns false when the suite setup failed.
+    inline bool runSuiteTests(std::ostream& output, std::string const & key, std::vector<Test*> const & tests, std::vector<Test*>& failed, RunCounts& counts, std::set<std::string> const & quarantine, RunOptions const & options, std::vector<Test*>* runOrder = nullptr)
+    {
+        if(!key.empty())
+        {
+            if(!runSuite(output, true, key, counts.passed, counts.failed, options))
+            {
+                output  << "Test suite setup failed."
+                        << " Skipping tests in suite."
+                        << std::endl;
+                return false;
+            }
+        }
+
+        for(auto * test : tests)
+        {
+            if(runOrder != nullptr)
+            {
+                runOrder->push_back(test);
+            }
+            int failedBefore = counts.failed;
+            runTest(output, test, counts.passed, counts.failed, counts.missedFailed, options);
+            if(counts.failed > failedBefore)
+            {
+                failed.push_back(test);
+            }
+        }
+
+        if(!key.empty())
+        {
+            if(!runSuite(output, false, key, counts.passed, counts.failed, options))
+            {
+                output  << "Test suite teardown failed."
+                        << std::endl;
+            }
+        }
+
+        if(options.retries > 0 && !failed.empty())
+        {
+            retryTests(output, key, failed, counts.failed, counts.flaky, options);
+        }
+
+        for(auto * test : failed)
+        {
+            if(quarantine.contains(getQualifiedName(test)))
+            {
+                output  << "Quarantined failure: "
+                        << test->getName()
+                        << std::endl;
+                --counts.failed;
+                ++counts.quarantined;
+            }
+        }
+        return true;
+    }
+
+    //Hands out the suites in getTests() in topological order of their
+    //declared dependencies. Among ready suites the map order is kept, so
+    //with no dependencies the order is the same as before. A suite whose
+    //upstream suite failed setup or was skipped is handed out with a skip
+    //reason instead of being run.
+    class SuiteScheduler
+    {
+        public:
+            SuiteScheduler() : SuiteScheduler(registeredSuites(), getSuiteDependencies(), getSuiteResources()) {}
+
+            //Schedules the named suites with the given dependencies and
+            //resources instead of the registered ones.
+            SuiteScheduler(std::vector<std::string> names,
+                std::map<std::string, std::set<std::string>> dependencies,
+                std::map<std::string, std::set<std::string>> resources)
+                : mNames(std::move(names)), mStates(mNames.size(), State::Pending),
+                mDependencies(std::move(dependencies)), mResources(std::move(resources)),
+                mRunning(0), mFinished(0)
+            {}
+
+            //Call before handing out any suite.
+            void shuffle(std::uint64_t seed)
+            {
+                shuffleOrder(mNames, seed);
+            }
+
+            //Blocks until a suite can start. Returns false once every suite
+            //has been handed out and finished.
+            bool next(std::size_t& index, std::string& skipReason)
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                while(true)
+                {
+                    if(mFinished == mNames.size())
+                    {
+                        return false;
+                    }
+
+                    for(std::size_t i = 0; i < mNames.size(); ++i)
+                    {
+                        if(mStates[i] == State::Pending && isReady(i, skipReason))
+                        {
+                            index = i;
+                            start(i, skipReason.empty());
+                            return true;
+                        }
+                    }
+
+                    if(mRunning == 0)
+                    {
+                        //Nothing is running and nothing is ready, so the
+                        //pending suites depend on each other.
+                        for(std::size_t i = 0; i < mNames.size(); ++i)
+                        {
+                            if(mStates[i] == State::Pending)
+                            {
+                                index = i;
+                                skipReason = "Dependency cycle.";
+                                start(i, false);
+                                return true;
+                            }
+                        }
+                    }
+                    mChanged.wait(lock);
+                }
+            }
+
+            void finish(std::size_t index, bool setupPassed, bool skipped)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mStates[index] = skipped ? State::Skipped : (setupPassed ? State::Passed : State::SetupFailed);
+                    if(!skipped)
+                    {
+                        for(auto const & resource : resourcesOf(mNames[index]))
+                        {
+                            mBusyResources.erase(resource);
+                        }
+                    }
+                    --mRunning;
+                    ++mFinished;
+                }
+                mChanged.notify_all();
+            }
+
+            std::string const & getName(std::size_t index) const { return mNames[index]; }
+
+        private:
+            enum class State
+            {
+                Pending,
+                Running,
+                Passed,
+                SetupFailed,
+                Skipped
+            };
+
+            static std::vector<std::string> registeredSuites()
+            {
+                std::vector<std::string> names;
+                for(auto const & [key, value] : getTests())
+                {
+                    names.push_back(key);
+                }
+                return names;
+            }
+
+            std::set<std::string> const & resourcesOf(std::string const & name) const
+            {
+                static std::set<std::string> const none;
+                auto resources = mResources.find(name);
+                return resources == mResources.end() ? none : resources->second;
+            }
+
+            bool isReady(std::size_t index, std::string& skipReason) const
+            {
+                skipReason.clear();
+                auto dependencies = mDependencies.find(mNames[index]);
+                if(dependencies != mDependencies.end())
+                {
+                    for(auto const & upstream : dependencies->second)
+                    {
+                        auto found = std::find(mNames.begin(), mNames.end(), upstream);
+                        if(found == mNames.end())
+                        {
+                            skipReason = "Depends on unknown suite " + upstream + ".";
+                            return true;
+                        }
+                        State state = mStates[static_cast<std::size_t>(found - mNames.begin())];
+                        if(state == State::Pending || state == State::Running)
+                        {
+                            return false;
+                        }
+                        if(state == State::SetupFailed)
+                        {
+                            skipReason = "Upstream suite " + upstream + " setup failed.";
+                            return true;
+                        }
+                        if(state == State::Skipped)
+                        {
+                            skipReason = "Upstream suite " + upstream + " was skipped.";
+                            return true;
+                        }
+                    }
+                }
+
+                for(auto const & resource : resourcesOf(mNames[index]))
+                {
+                    if(mBusyResources.contains(resource))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void start(std::size_t index, bool run)
+            {
+                mStates[index] = State::Running;
+                ++mRunning;
+                if(run)
+                {
+                    for(auto const & resource : resourcesOf(mNames[index]))
+                    {
+                        mBusyResources.insert(resource);
+                    }
+                }
+            }
+
+            std::vector<std::string> mNames;
+            std::vector<State> mStates;
+            std::map<std::string, std::set<std::string>> mDependencies;
+            std::map<std::string, std::set<std::string>> mResources;
+            std::set<std::string> mBusyResources;
+            std::size_t mRunning;
+            std::size_t mFinished;
+            std::mutex mMutex;
+            std::condition_variable mChanged;
+    };
+
+    //Lock-free multiple producer, single consumer queue of text. Workers
+    //push whole suite reports and one writer thread prints them, so no
+    //worker waits on the output stream or on another worker.
+    class LogQueue
+    {
+        public:
+            LogQueue() : mHead(&mStub), mTail(&mStub), mSignal(0), mClosed(false) {}
+
+            ~LogQueue()
+            {
+                std::string text;
+                while(pop(text))
+                {
+                }
+                if(mTail != &mStub)
+                {
+                    delete mTail;
+                }
+            }
+
+            LogQueue(LogQueue const &) = delete;
+            LogQueue& operator=(LogQueue const &) = delete;
+
+            void push(std::string text)
+            {
+                Node* node = new Node;
+                node->text = std::move(text);
+                Node* previous = mHead.exchange(node, std::memory_order_acq_rel);
+                previous->next.store(node, std::memory_order_release);
+                signal();
+            }
+
+            //Consumer only.
+            bool pop(std::string& text)
+            {
+                Node* tail = mTail;
+                Node* next = tail->next.load(std::memory_order_acquire);
+                if(next == nullptr)
+                {
+                    return false;
+                }
+                text = std::move(next->text);
+                mTail = next;
+                if(tail != &mStub)
+                {
+                    delete tail;
+                }
+                return true;
+            }
+
+            //Consumer only. Waits for text and returns false once the queue
+            //is closed and empty.
+            bool waitPop(std::string& text)
+            {
+                while(true)
+                {
+                    std::uint32_t seen = mSignal.load(std::memory_order_acquire);
+                    if(pop(text))
+                    {
+                        return true;
+                    }
+                    if(mClosed.load(std::memory_order_acquire))
+                    {
+                        return pop(text);
+                    }
+                    mSignal.wait(seen, std::memory_order_acquire);
+                }
+            }
+
+            void close()
+            {
+                mClosed.store(true, std::memory_order_release);
+                signal();
+            }
+
+        private:
+            struct Node
+            {
+                std::atomic<Node*> next = nullptr;
+                std::string text;
+            };
+
+            void signal()
+            {
+                mSignal.fetch_add(1, std::memory_order_release);
+                mSignal.notify_one();
+            }
+
+            Node mStub;
+            std::atomic<Node*> mHead;
+            Node* mTail;
+            std::atomic<std::uint32_t> mSignal;
+            std::atomic<bool> mClosed;
+    };
+
+    //Runs the tests in the given order. Consecutive tests of a suite run
+    //between one setup and teardown of that suite. Returns true when the
+    //last test failed.
+    inline bool runSequence(std::ostream& output, std::vector<Test*> const & sequence, RunOptions const & options)
+    {
+        int passed = 0;
+        int failed = 0;
+        int missedFailed = 0;
+        bool lastFailed = false;
+        std::size_t i = 0;
+        while(i < sequence.size())
+        {
+            std::string key(sequence[i]->getSuiteName());
+            if(!key.empty())
+            {
+                for(auto * suite : getTestSuites().at(key))
+                {
+                    suite->reset();
+                }
+                if(!runSuite(output, true, key, passed, failed, options))
+                {
+                    return false;
+                }
+            }
+
+            for(; i < sequence.size() && sequence[i]->getSuiteName() == key; ++i)
+            {
+                int failedBefore = failed;
+                sequence[i]->reset();
+                runTest(output, sequence[i], passed, failed, missedFailed, options);
+                lastFailed = failed > failedBefore;
+            }
+
+            if(!key.empty())
+            {
+                runSuite(output, false, key, passed, failed, options);
+            }
+        }
+        return lastFailed;
+    }
+
+    //Runs the sequence in a new process of the test program so state left
+    //behind by earlier tests in this process cannot leak in. Returns 1 when
+    //the last test failed, 0 when it passed and -1 when it could not run.
+    inline int runSequenceIsolated(std::vector<Test*> const & sequence, [[maybe_unused]] RunOptions const & options)
+    {
+#if SOURAVTDD_POSIX
+        char path[] = "/tmp/souravtdd_sequence_XXXXXX";
+        int fd = mkstemp(path);
+        if(fd == -1)
+        {
+            return -1;
+        }
+        std::string names;
+        for(auto const * test : sequence)
+        {
+            names += getQualifiedName(test);
+            names += "\n";
+        }
+        bool written = write(fd, names.data(), names.size()) == static_cast<ssize_t>(names.size());
+        close(fd);
+        if(!written)
+        {
+            unlink(path);
+            return -1;
+        }
+
+#if defined(__linux__)
+        std::string program = "/proc/self/exe";
+#else
+        std::string program = options.program;
+#endif
+        std::string sequenceArg = std::string("--sequence=") + path;
+        std::cout.flush();
+        std::fflush(stdout);
+        pid_t child = fork();
+        if(child == 0)
+        {
+            int null = open("/dev/null", O_WRONLY);
+            dup2(null, STDOUT_FILENO);
+            dup2(null, STDERR_FILENO);
+            char* args[] = {program.data(), sequenceArg.data(), nullptr};
+            execv(program.c_str(), args);
+            _exit(127);
+        }
+
+        int status = 0;
+        bool waited = child > 0 && waitpid(child, &status, 0) == child;
+        unlink(path);
+        if(!waited || !WIFEXITED(status) || WEXITSTATUS(status) > 1)
+        {
+            return -1;
+        }
+        return WEXITSTATUS(status);
+#else
+        (void)sequence;
+        (void)options;
+        return -1;
+#endif
+    }
+
+    //The failing test is run alone, then after halves of the tests that ran
+    //before it, keeping the half that still makes it fail. This finds a
+    //single polluting test in O(log n) runs. Every trial is a new process.
+    inline void bisectOrderDependency(std::ostream& output, std::vector<Test*> const & runOrder, Test* victim, RunOptions const & options)
+    {
+        output  << "----------------------------------\n"
+                << "Bisecting " << getQualifiedName(victim) << "\n";
+
+        int alone = runSequenceIsolated({victim}, options);
+        if(alone == -1)
+        {
+            output << "Could not start the test program.\n";
+            return;
+        }
+        if(alone == 1)
+        {
+            output << "Fails when run alone. Not an order dependency.\n";
+            return;
+        }
+
+        auto position = std::find(runOrder.begin(), runOrder.end(), victim);
+        std::vector<Test*> candidates(runOrder.begin(), position);
+        auto failsAfter = [&](std::vector<Test*> const & preceding)
+        {
+            std::vector<Test*> sequence = preceding;
+            sequence.push_back(victim);
+            bool fails = runSequenceIsolated(sequence, options) == 1;
+            output  << "After " << preceding.size() << " tests: "
+                    << (fails ? "fails" : "passes") << "\n";
+            return fails;
+        };
+
+        if(!failsAfter(candidates))
+        {
+            output << "Passes after the same tests. Could not reproduce the failure.\n";
+            return;
+        }
+
+        while(candidates.size() > 1)
+        {
+            std::size_t half = candidates.size() / 2;
+            std::vector<Test*> first(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(half));
+            std::vector<Test*> second(candidates.begin() + static_cast<std::ptrdiff_t>(half), candidates.end());
+            if(failsAfter(first))
+            {
+                candidates = std::move(first);
+            }
+            else if(failsAfter(second))
+            {
+                candidates = std::move(second);
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if(candidates.size() == 1)
+        {
+            output << "Polluting test: " << getQualifiedName(candidates.front()) << "\n";
+            return;
+        }
+        output << "The failure needs tests from both halves of:\n";
+        for(auto const * test : candidates)
+        {
+            output << getQualifiedName(test) << "\n";
+        }
+    }
+
+    //Used by a process started with --sequence. Returns 1 when the last
+    //test failed and 2 when a name does not match any test.
+    inline int runSequenceFile(std::ostream& output, RunOptions const & options)
+    {
+        std::map<std::string, Test*> byName;
+        for(auto const & [key, value] : getTests())
+        {
+            for(auto * test : value)
+            {
+                byName[getQualifiedName(test)] = test;
+            }
+        }
+
+        std::vector<Test*> sequence;
+        std::ifstream file(options.sequenceFile);
+        std::string line;
+        while(std::getline(file, line))
+        {
+            auto found = byName.find(line);
+            if(found == byName.end())
+            {
+                output << "Test not found: " << line << std::endl;
+                return 2;
+            }
+            sequence.push_back(found->second);
+        }
+        return runSequence(output, sequence, options) ? 1 : 0;
+    }
+
+    inline int runTests(std::ostream& output, RunOptions const & options = RunOptions())
+    {
+        if(!options.sequenceFile.empty())
+        {
+            return runSequenceFile(output, options);
+        }
+
+        output      << "Running "
+                    << getTests().size()
+                    << " tests\n";
+
+        if(!options.flightRecorderFile.empty())
+        {
+            std::string path = getFlightRecorderPath(options);
+            if(!getFlightRecorder().open(path))
+            {
+#if SOURAVTDD_POSIX
+                path += "." + std::to_string(getpid());
+#endif
+                if(!getFlightRecorder().open(path))
+                {
+                    output << "Cannot open flight recorder file: " << path << std::endl;
+                }
+            }
+        }
+        getFlightRecorder().record(FlightEvent::RunStart, "");
+
+        for(auto const & [key, value] : getTests())
+        {
+            if(!key.empty() && !getTestSuites().contains(key))
+            {
+                output  << "---------------Suite: "
+                        << key
+                        << std::endl;
+                output  << "Test suite not found."
+                        << " Exiting test application."
+                        << std::endl;
+
+                getFlightRecorder().close();
+                return 1;
+            }
+        }
+
+        RunOptions runOptions = options;
+        if(options.shuffle)
+        {
+            if(!options.hasSeed)
+            {
+                runOptions.seed = std::random_device()();
+            }
+            output  << "Shuffle seed: " << runOptions.seed
+                    << " (replay with --shuffle=" << runOptions.seed << ")"
+                    << std::endl;
+        }
+
+        int jobs = options.jobs < 1 ? 1 : options.jobs;
+        if(jobs > 1)
+        {
+            runOptions.profileDir.clear();
+            //Resource usage covers the whole process, so another suite's
+            //thread would count against the test being checked.
+            if(runOptions.failOnFdLeak || runOptions.maxRssGrowthKb > 0)
+            {
+                output  << "Resource budgets need a single job."
+                        << " Not checking them."
+                        << std::endl;
+                runOptions.failOnFdLeak = false;
+                runOptions.maxRssGrowthKb = 0;
+            }
+        }
+
+#if SOURAVTDD_PROFILER
+        if(!runOptions.profileDir.empty() && !makeDirectories(runOptions.profileDir))
+        {
+            output  << "Cannot write profile: "
+                    << runOptions.profileDir
+                    << std::endl;
+            runOptions.profileDir.clear();
+        }
+#endif
+
+        if(!runOptions.profileDir.empty())
+        {
+            //Allocate the sample buffer now so the first test's RSS does not include it.
+            getProfiler();
+        }
+
+        std::set<std::string> quarantine;
+        if(!options.quarantineFile.empty())
+        {
+            quarantine = loadQuarantine(options.quarantineFile);
+        }
+
+        RunCounts counts;
+        std::map<std::string, std::vector<Test*>> failedBySuite;
+        std::mutex resultsMutex;
+        std::vector<Test*> runOrder;
+        SuiteScheduler scheduler;
+        if(options.shuffle)
+        {
+            scheduler.shuffle(runOptions.seed);
+        }
+        LogQueue log;
+
+        auto worker = [&]()
+        {
+            std::size_t index = 0;
+            std::string skipReason;
+            while(scheduler.next(index, skipReason))
+            {
+                std::string const & key = scheduler.getName(index);
+                std::ostringstream buffer;
+                std::ostream& suiteOutput = jobs > 1 ? buffer : output;
+
+                suiteOutput << "---------------Suite: "
+                            << (key.empty() ? "Single Tests" : key)
+                            << std::endl;
+
+                if(!skipReason.empty())
+                {
+                    suiteOutput << skipReason
+                                << " Skipping suite."
+                                << std::endl;
+                    if(jobs > 1)
+                    {
+                        log.push(buffer.str());
+                    }
+                    scheduler.finish(index, false, true);
+                    continue;
+                }
+
+                std::vector<Test*> tests = getTests().at(key);
+                if(options.shuffle)
+                {
+                    //Seeded per suite so the order does not depend on which
+                    //worker picks the suite up.
+                    shuffleOrder(tests, runOptions.seed + index + 1);
+                }
+
+                RunCounts suiteCounts;
+                std::vector<Test*> failed;
+                std::vector<Test*> suiteRunOrder;
+                bool setupPassed = runSuiteTests(suiteOutput, key, tests, failed, suiteCounts, quarantine, runOptions, &suiteRunOrder);
+                if(jobs > 1)
+                {
+                    log.push(buffer.str());
+                }
+                {
+                    std::lock_guard<std::mutex> lock(resultsMutex);
+                    counts += suiteCounts;
+                    runOrder.insert(runOrder.end(), suiteRunOrder.begin(), suiteRunOrder.end());
+                    if(setupPassed)
+                    {
+                        failedBySuite[key] = std::move(failed);
+                    }
+                }
+                scheduler.finish(index, setupPassed, false);
+            }
+        };
+
+        if(jobs == 1)
+        {
+            worker();
+        }
+        else
+        {
+            std::thread writer([&]()
+            {
+                std::string text;
+                while(log.waitPop(text))
+                {
+                    output << text << std::flush;
+                }
+            });
+            std::unique_ptr<ThreadStreamRouting> routing;
+            if(runOptions.captureOutput)
+            {
+                routing = std::make_unique<ThreadStreamRouting>();
+            }
+            std::vector<std::thread> workers;
+            for(int i = 0; i < jobs; ++i)
+            {
+                workers.emplace_back(worker);
+            }
+            for(auto& thread : workers)
+            {
+                thread.join();
+            }
+            log.close();
+            writer.join();
+        }
+
+        std::map<std::string, FlakyRecord> history;
+        if(!options.historyFile.empty())
+        {
+            history = loadFlakyHistory(options.historyFile);
+        }
+        std::vector<Test*> flakyTests;
+        for(auto const & [key, failed] : failedBySuite)
+        {
+            for(auto * test : getTests().at(key))
+            {
+                if(test->isFlaky())
+                {
+                    flakyTests.push_back(test);
+                }
+                if(!options.historyFile.empty())
+                {
+                    FlakyRecord& record = history[getQualifiedName(test)];
+                    ++record.runs;
+                    if(std::find(failed.begin(), failed.end(), test) != failed.end())
+                    {
+                        ++record.failures;
+                    }
+                    if(test->isFlaky())
+                    {
+                        ++record.flaky;
+                    }
+                }
+            }
+        }
+
+        if(!options.historyFile.empty())
+        {
+            saveFlakyHistory(options.historyFile, history);
+        }
+
+        if(!flakyTests.empty())
+        {
+            output  << "----------------------------------\n";
+            output  << "Flaky tests:\n";
+            for(auto const * test : flakyTests)
+            {
+                output << getQualifiedName(test);
+                auto record = history.find(getQualifiedName(test));
+                if(record != history.end())
+                {
+                    output  << " (flaky in " << record->second.flaky
+                            << " of " << record->second.runs << " runs)";
+                }
+                output << "\n";
+            }
+        }
+
+        if(options.resourceSummary)
+        {
+            reportResourceSummary(output);
+        }
+
+        if(options.bisect)
+        {
+            if(jobs > 1)
+            {
+                output  << "----------------------------------\n"
+                        << "Bisecting needs a single job. Skipping.\n";
+            }
+            else
+            {
+                for(auto const & [key, failed] : failedBySuite)
+                {
+                    for(auto * test : failed)
+                    {
+                        bisectOrderDependency(output, runOrder, test, runOptions);
+                    }
+                }
+            }
+        }
+
+        output  << "----------------------------------\n";
+        output  << "Tests passed: " << counts.passed
+                << "\nTests failed: " << counts.failed;
+        
+        if(counts.missedFailed > 0)
+        {
+            output  << "\nTests failures missed: "
+                    << counts.missedFailed;
+        }
+        if(counts.flaky > 0)
+        {
+            output  << "\nTests flaky: "
+                    << counts.flaky;
+        }
+        if(counts.quarantined > 0)
+        {
+            output  << "\nTests quarantined: "
+                    << counts.quarantined;
+        }
         output << std::endl;
-        return numFailed;
+        getFlightRecorder().record(FlightEvent::RunEnd, "", counts.failed);
+        getFlightRecorder().close();
+        return counts.failed;
+    }
+
+    //A fatal failure throws the confirm exception so the test stops. A soft
+    //failure is recorded on the running test and the test keeps going.
+    template <typename ExceptionT>
+    bool failConfirm(ExceptionT const & ex, std::source_location const & location, ConfirmMode mode)
+    {
+        TestBase* current = getCurrentTest();
+#if SOURAVTDD_EXCEPTIONS
+        if(mode == ConfirmMode::Fatal || current == nullptr)
+        {
+            ExceptionT fatal = ex;
+            fatal.setFile(location.file_name());
+            throw fatal;
+        }
+#else
+        if(current == nullptr)
+        {
+            //Nothing to record the failure on and no way to unwind.
+            std::abort();
+        }
+#endif
+        current->setFailed(ex.getReason(), ex.getLine(), location.file_name());
+        return false;
+    }
+
+    //How confirm compares and prints values of type T. Specialize it for
+    //types that need their own equality or tolerance, like fixed point.
+    template <typename T>
+    struct ConfirmTraits
+    {
+        static bool equal(T const & expected, T const & actual)
+        {
+            return expected == actual;
+        }
+
+        static std::string toString(T const & value)
+        {
+            if constexpr (requires { std::to_string(value); })
+            {
+                return std::to_string(value);
+            }
+            else if constexpr (requires(std::ostream& stream) { stream << value; })
+            {
+                std::ostringstream stream;
+                stream << value;
+                return stream.str();
+            }
+            else
+            {
+                return "(not printable)";
+            }
+        }
+    };
+
+    template <std::floating_point T>
+    struct ConfirmTraits<T>
+    {
+        static constexpr T tolerance = std::is_same_v<T, float> ? T(0.0001) : T(0.000001);
+
+        static bool equal(T const & expected, T const & actual)
+        {
+            return !(actual < (expected - tolerance) || actual > (expected + tolerance));
+        }
+
+        static std::string toString(T const & value)
+        {
+            return std::to_string(value);
+        }
+    };
+
+    template <typename T>
+    bool confirmValue(T const & expected, T const & actual, std::source_location const & location, ConfirmMode mode)
+    {
+        if (!ConfirmTraits<T>::equal(expected, actual))
+        {
+            return failConfirm(ActualConfirmException(ConfirmTraits<T>::toString(expected), ConfirmTraits<T>::toString(actual), location.line()), location, mode);
+        }
+        return true;
+    }
+
+    inline bool confirm(bool expected, bool actual, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
+    {
+        if (expected != actual)
+        {
+            return failConfirm(BoolConfirmException(expected, location.line()), location, mode);
+        }
+        return true;
+    }
+
+    inline bool confirmText(std::string_view expected, std::string_view actual, const std::source_location location, ConfirmMode mode);
+
+    inline bool confirm(std::string_view expected, std::string_view actual, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
+    {
+        //Long values are reported as a window around the first difference.
+        if (expected.size() > 1024 || actual.size() > 1024)
+        {
+            return confirmText(expected, actual, location, mode);
+        }
+        if (expected != actual)
+        {
+            return failConfirm(ActualConfirmException(expected, actual, location.line()), location, mode);
+        }
+        return true;
+    }
+
+    inline bool confirm(std::string expected, std::string actual, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
+    {
+        return confirm(std::string_view(expected), std::string_view(actual), location, mode);
+    }
+
+    inline bool confirm(float expected, float actual, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
+    {
+        return confirmValue(expected, actual, location, mode);
+    }
+
+    inline bool confirm(double expected, double actual, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
+    {
+        return confirmValue(expected, actual, location, mode);
+    }
+
+    inline bool confirm(long double expected, long double actual, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
+    {
+        return confirmValue(expected, actual, location, mode);
+    }
+
+    template <typename T>
+    bool confirm(T const & expected, T const & actual, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
+    {
+        return confirmValue(expected, actual, location, mode);
+    }
+
+    //Offset of the first byte that differs within size bytes, or size when
+    //they are equal. memcmp, which the C library vectorizes, skips equal
+    //blocks, then word compares find the byte within the block that differs.
+    inline std::size_t firstDifference(unsigned char const * left, unsigned char const * right, std::size_t size)
+    {
+        constexpr std::size_t block = 4096;
+        std::size_t offset = 0;
+        while(size - offset >= block && std::memcmp(left + offset, right + offset, block) == 0)
+        {
+            offset += block;
+        }
+        while(size - offset >= sizeof(std::uint64_t))
+        {
+            std::uint64_t leftWord;
+            std::uint64_t rightWord;
+            std::memcpy(&leftWord, left + offset, sizeof(leftWord));
+            std::memcpy(&rightWord, right + offset, sizeof(rightWord));
+            std::uint64_t difference = leftWord ^ rightWord;
+            if(difference != 0)
+            {
+                if constexpr (std::endian::native == std::endian::little)
+                {
+                    return offset + static_cast<std::size_t>(std::countr_zero(difference)) / 8;
+                }
+                else
+                {
+                    return offset + static_cast<std::size_t>(std::countl_zero(difference)) / 8;
+                }
+            }
+            offset += sizeof(std::uint64_t);
+        }
+        while(offset < size && left[offset] == right[offset])
+        {
+            ++offset;
+        }
+        return offset;
+    }
+
+    //Views a string, or a contiguous range of trivially copyable values, as bytes.
+    template <typename RangeT>
+    std::span<unsigned char const> asBytes(RangeT const & range)
+    {
+        if constexpr (std::is_convertible_v<RangeT const &, std::string_view>)
+        {
+            std::string_view text = range;
+            return std::span<unsigned char const>(reinterpret_cast<unsigned char const *>(text.data()), text.size());
+        }
+        else
+        {
+            using ValueT = std::remove_cvref_t<decltype(*std::data(range))>;
+            static_assert(std::is_trivially_copyable_v<ValueT>, "CONFIRM_BYTES compares the bytes of trivially copyable values.");
+            return std::span<unsigned char const>(reinterpret_cast<unsigned char const *>(std::data(range)), std::size(range) * sizeof(ValueT));
+        }
+    }
+
+    //Up to 8 bytes before offset and 16 from it in hex. The byte at offset
+    //is in brackets, or [end] when the value ends there.
+    inline std::string formatByteWindow(std::span<unsigned char const> bytes, std::size_t offset)
+    {
+        constexpr char digits[] = "0123456789abcdef";
+        std::size_t start = offset > 8 ? offset - 8 : 0;
+        std::size_t end = std::min(bytes.size(), offset + 16);
+        std::string window = "@" + std::to_string(start) + ":";
+        for(std::size_t i = start; i < end; ++i)
+        {
+            window += i == offset ? " [" : " ";
+            window += digits[bytes[i] >> 4];
+            window += digits[bytes[i] & 0xf];
+            if(i == offset)
+            {
+                window += "]";
+            }
+        }
+        if(offset >= bytes.size())
+        {
+            window += " [end]";
+        }
+        else if(end < bytes.size())
+        {
+            window += " ...";
+        }
+        return window;
+    }
+
+    //Up to 32 characters either side of offset with control characters
+    //escaped. column is set to where offset lands in the window.
+    inline std::string formatTextWindow(std::string_view text, std::size_t offset, std::size_t& column)
+    {
+        constexpr char digits[] = "0123456789abcdef";
+        std::size_t start = offset > 32 ? offset - 32 : 0;
+        std::size_t end = std::min(text.size(), offset + 32);
+        std::string window = start > 0 ? "..." : "";
+        column = window.size();
+        for(std::size_t i = start; i < end; ++i)
+        {
+            if(i == offset)
+            {
+                column = window.size();
+            }
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            switch(c)
+            {
+                case '\n': window += "\\n"; break;
+                case '\r': window += "\\r"; break;
+                case '\t': window += "\\t"; break;
+                case '\\': window += "\\\\"; break;
+                default:
+                    if(c < 0x20 || c == 0x7f)
+                    {
+                        window += "\\x";
+                        window += digits[c >> 4];
+                        window += digits[c & 0xf];
+                    }
+                    else
+                    {
+                        window += static_cast<char>(c);
+                    }
+            }
+        }
+        if(offset >= end)
+        {
+            column = window.size();
+        }
+        if(end < text.size())
+        {
+            window += "...";
+        }
+        return window;
+    }
+
+    //Compares byte buffers of any size. A failure reports the lengths, the
+    //first offset that differs and a hex window around it, so the reason
+    //stays small however large the buffers are.
+    inline bool confirmBytes(std::span<unsigned char const> expected, std::span<unsigned char const> actual, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
+    {
+        std::size_t common = std::min(expected.size(), actual.size());
+        std::size_t offset = firstDifference(expected.data(), actual.data(), common);
+        if(offset == common && expected.size() == actual.size())
+        {
+            return true;
+        }
+        std::string summary = "Bytes differ at offset " + std::to_string(offset)
+            + ". Expected " + std::to_string(expected.size())
+            + " bytes, actual " + std::to_string(actual.size()) + ".";
+        return failConfirm(DifferenceConfirmException(summary, formatByteWindow(expected, offset), formatByteWindow(actual, offset), location.line()), location, mode);
+    }
+
+    //Compares text of any size. A failure reports the lengths, the offset,
+    //line and column of the first difference and a window of text around
+    //it with a marker under the difference.
+    inline bool confirmText(std::string_view expected, std::string_view actual, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
+    {
+        std::size_t common = std::min(expected.size(), actual.size());
+        std::size_t offset = firstDifference(reinterpret_cast<unsigned char const *>(expected.data()),
+            reinterpret_cast<unsigned char const *>(actual.data()), common);
+        if(offset == common && expected.size() == actual.size())
+        {
+            return true;
+        }
+        std::string_view before = expected.substr(0, offset);
+        std::size_t line = static_cast<std::size_t>(std::count(before.begin(), before.end(), '\n')) + 1;
+        std::size_t lineStart = before.rfind('\n');
+        std::size_t column = lineStart == std::string_view::npos ? offset + 1 : offset - lineStart;
+        std::string summary = "Text differs at offset " + std::to_string(offset)
+            + ", line " + std::to_string(line) + ", column " + std::to_string(column)
+            + ". Expected " + std::to_string(expected.size())
+            + " chars, actual " + std::to_string(actual.size()) + ".";
+
+        std::size_t marker = 0;
+        std::string expectedWindow = formatTextWindow(expected, offset, marker);
+        std::string actualWindow = formatTextWindow(actual, offset, marker);
+        actualWindow += "\n" + std::string(std::strlen("Actual:   ") + marker, ' ') + "^";
+        return failConfirm(DifferenceConfirmException(summary, expectedWindow, actualWindow, location.line()), location, mode);
+    }
+
+    //Soft confirm. A mismatch is added to the running test's failures and
+    //the test carries on so every mismatch is reported in one run.
+    template <typename ExpectedT, typename ActualT>
+    bool check(ExpectedT const & expected, ActualT const & actual, const std::source_location location = std::source_location::current())
+    {
+        return confirm(expected, actual, location, ConfirmMode::Soft);
+    }
+
+    //Every mock call takes a number from this counter so calls to
+    //different mocks can be ordered.
+    inline std::atomic<std::uint64_t>& getMockSequence()
+    {
+        static std::atomic<std::uint64_t> sequence = 0;
+        return sequence;
+    }
+
+    struct AnyArg {};
+    inline constexpr AnyArg anything{};
+
+    //Kept in the ring buffer in place of an argument that cannot be copied.
+    struct NotRecorded {};
+
+    //How a mock keeps one argument in its ring buffer. Copyable values are
+    //copied. A reference to a type that cannot be copied, such as an
+    //abstract class, is kept as a pointer that is only valid while the
+    //caller's object lives. Anything else, such as a move-only value, is
+    //not recorded.
+    template <typename ArgT>
+    struct MockArg
+    {
+        using Decayed = std::decay_t<ArgT>;
+        static constexpr bool copied = !std::is_abstract_v<Decayed> && std::is_copy_assignable_v<Decayed>;
+        static constexpr bool pointed = !copied && std::is_reference_v<ArgT>;
+        using Stored = std::conditional_t<copied, Decayed,
+            std::conditional_t<pointed, std::remove_reference_t<ArgT>*, NotRecorded>>;
+
+        static void store(Stored& slot, std::remove_reference_t<ArgT>& value)
+        {
+            if constexpr (copied)
+            {
+                //Assignment reuses the storage already in the slot.
+                slot = value;
+            }
+            else if constexpr (pointed)
+            {
+                slot = &value;
+            }
+        }
+    };
+
+    //A matcher is anything, a predicate taking the argument, or a value
+    //compared with ==.
+    template <typename MatcherT, typename ValueT>
+    bool matchArg(MatcherT const & matcher, ValueT const & value)
+    {
+        if constexpr (std::is_same_v<MatcherT, AnyArg>)
+        {
+            return true;
+        }
+        else if constexpr (std::is_invocable_r_v<bool, MatcherT const &, ValueT const &>)
+        {
+            return matcher(value);
+        }
+        else
+        {
+            return matcher == value;
+        }
+    }
+
+    template <typename SignatureT>
+    class MockFunction;
+
+    //Records each call's arguments into a ring buffer that is allocated
+    //once. Only the last capacity calls are kept, but the call count and
+    //the first call's sequence cover every call.
+    template <typename ReturnT, typename... ArgsT>
+    class MockFunction<ReturnT(ArgsT...)>
+    {
+        public:
+            using ArgsTuple = std::tuple<typename MockArg<ArgsT>::Stored...>;
+            using ValueT = std::conditional_t<std::is_void_v<ReturnT>, char, std::decay_t<ReturnT>>;
+
+            MockFunction(std::string_view name, std::size_t capacity = 256) :
+            mName(name),
+            mCalls(std::bit_ceil(capacity)),
+            mMask(mCalls.size() - 1),
+            mCount(0),
+            mFirstSequence(0),
+            mReturn()
+            {}
+            MockFunction(MockFunction const &) = delete;
+            MockFunction& operator=(MockFunction const &) = delete;
+
+            ReturnT operator()(ArgsT... args)
+            {
+                std::uint64_t sequence = getMockSequence().fetch_add(1, std::memory_order_relaxed) + 1;
+                Call& call = mCalls[mCount & mMask];
+                std::apply([&](auto &... slots)
+                {
+                    (MockArg<ArgsT>::store(slots, args), ...);
+                }, call.args);
+                call.sequence = sequence;
+                if(mCount == 0)
+                {
+                    mFirstSequence = sequence;
+                }
+                ++mCount;
+
+                if(mAction)
+                {
+                    return mAction(std::forward<ArgsT>(args)...);
+                }
+                if constexpr (!std::is_void_v<ReturnT>)
+                {
+                    return mReturn;
+                }
+            }
+
+            void returns(ValueT value) { mReturn = std::move(value); }
+            void invokes(std::function<ReturnT(ArgsT...)> action) { mAction = std::move(action); }
+
+            void reset()
+            {
+                mCount = 0;
+                mFirstSequence = 0;
+            }
+
+            std::string_view getName() const { return mName; }
+            std::size_t getCapacity() const { return mCalls.size(); }
+            std::size_t callCount() const { return mCount; }
+            std::size_t retainedCount() const { return mCount < mCalls.size() ? mCount : mCalls.size(); }
+            std::uint64_t firstCallSequence() const { return mFirstSequence; }
+            std::uint64_t lastCallSequence() const { return mCount == 0 ? 0 : mCalls[(mCount - 1) & mMask].sequence; }
+
+            //Index 0 is the oldest call still in the buffer.
+            ArgsTuple const & call(std::size_t index) const
+            {
+                return mCalls[(mCount - retainedCount() + index) & mMask].args;
+            }
+
+            ArgsTuple const & lastCall() const
+            {
+                return mCalls[(mCount - 1) & mMask].args;
+            }
+
+            template <typename... MatchersT>
+            bool calledWith(MatchersT const &... matchers) const
+            {
+                static_assert(sizeof...(MatchersT) == sizeof...(ArgsT), "One matcher is needed for each argument.");
+                for(std::size_t i = 0; i < retainedCount(); ++i)
+                {
+                    bool matched = std::apply([&](auto const &... values)
+                    {
+                        return (matchArg(matchers, values) && ...);
+                    }, call(i));
+                    if(matched)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+        private:
+            struct Call
+            {
+                ArgsTuple args;
+                std::uint64_t sequence = 0;
+            };
+
+            std::string_view mName;
+            std::vector<Call> mCalls;
+            std::size_t mMask;
+            std::size_t mCount;
+            std::uint64_t mFirstSequence;
+            ValueT mReturn;
+            std::function<ReturnT(ArgsT...)> mAction;
+    };
+
+    template <typename SignatureT>
+    bool confirmCalls(MockFunction<SignatureT> const & mock, std::size_t expected, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
+    {
+        if (mock.callCount() != expected)
+        {
+            std::string expectedText(mock.getName());
+            expectedText += " called " + std::to_string(expected) + " times";
+            std::string actualText(mock.getName());
+            actualText += " called " + std::to_string(mock.callCount()) + " times";
+            return failConfirm(ActualConfirmException(expectedText, actualText, location.line()), location, mode);
+        }
+        return true;
     }
 
-    inline void confirm(bool expected, bool actual, const std::source_location location = std::source_location::current())
+    //Matchers are checked against the calls still in the ring buffer.
+    template <typename SignatureT, typename... MatchersT>
+    bool confirmCalledWith(std::source_location const & location, ConfirmMode mode, MockFunction<SignatureT> const & mock, MatchersT const &... matchers)
     {
-        if (expected != actual)
+        if (!mock.calledWith(matchers...))
         {
-            throw BoolConfirmException(expected, location.line());
+            std::string expectedText(mock.getName());
+            expectedText += " called with matching arguments";
+            std::string actualText(mock.getName());
+            actualText += " called " + std::to_string(mock.callCount()) + " times without a match";
+            if(mock.retainedCount() < mock.callCount())
+            {
+                actualText += " in the last " + std::to_string(mock.retainedCount()) + " calls";
+            }
+            return failConfirm(ActualConfirmException(expectedText, actualText, location.line()), location, mode);
         }
+        return true;
     }
 
-    inline void confirm(std::string_view expected, std::string_view actual, const std::source_location location = std::source_location::current())
+    //Every call to first must come before the first call to second. Calls
+    //dropped from the ring buffer are older than the ones kept, so the
+    //last call decides.
+    template <typename FirstSignatureT, typename SecondSignatureT>
+    bool confirmCalledBefore(MockFunction<FirstSignatureT> const & first, MockFunction<SecondSignatureT> const & second, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
     {
-        if (expected != actual)
+        std::uint64_t firstSequence = first.firstCallSequence();
+        std::uint64_t lastSequence = first.lastCallSequence();
+        std::uint64_t secondSequence = second.firstCallSequence();
+        if (firstSequence == 0 || secondSequence == 0 || lastSequence > secondSequence)
         {
-            throw ActualConfirmException(expected, actual, location.line());
+            std::string expectedText(first.getName());
+            expectedText += " called before ";
+            expectedText += second.getName();
+            std::string actualText;
+            if(firstSequence == 0)
+            {
+                actualText = std::string(first.getName()) + " was never called";
+            }
+            else if(secondSequence == 0)
+            {
+                actualText = std::string(second.getName()) + " was never called";
+            }
+            else if(firstSequence > secondSequence)
+            {
+                actualText = std::string(second.getName()) + " called first";
+            }
+            else
+            {
+                actualText = std::string(first.getName()) + " called again after ";
+                actualText += second.getName();
+            }
+            return failConfirm(ActualConfirmException(expectedText, actualText, location.line()), location, mode);
         }
+        return true;
     }
 
-    inline void confirm(std::string expected, std::string actual, const std::source_location location = std::source_location::current())
+    enum class Complexity
     {
-        if (expected != actual)
+        O1,
+        OLOGN,
+        ON,
+        ON_LOGN,
+        ON2
+    };
+
+    inline std::string_view complexityName(Complexity complexity)
+    {
+        switch(complexity)
+        {
+            case Complexity::O1: return "O(1)";
+            case Complexity::OLOGN: return "O(log n)";
+            case Complexity::ON: return "O(n)";
+            case Complexity::ON_LOGN: return "O(n log n)";
+            case Complexity::ON2: return "O(n^2)";
+        }
+        return "";
+    }
+
+    inline double complexityCurve(Complexity complexity, double n)
+    {
+        switch(complexity)
         {
-            confirm(std::string_view(expected), std::string_view(actual));
+            case Complexity::O1: return 1.0;
+            case Complexity::OLOGN: return std::log2(n);
+            case Complexity::ON: return n;
+            case Complexity::ON_LOGN: return n * std::log2(n);
+            case Complexity::ON2: return n * n;
         }
+        return 1.0;
     }
 
-    inline void confirm(float expected, float actual, const std::source_location location = std::source_location::current())
+    struct ComplexityFit
+    {
+        Complexity complexity;
+        double coefficient;
+        //Root mean square of the residuals divided by the mean time.
+        double rms;
+    };
+
+    //Least squares fit of time = coefficient * f(n) for one curve.
+    inline ComplexityFit fitComplexity(Complexity complexity, std::vector<std::size_t> const & sizes, std::vector<double> const & times)
     {
-        if (actual < (expected - 0.0001f) || actual > (expected + 0.0001f))
+        double sumTimeCurve = 0.0;
+        double sumCurveCurve = 0.0;
+        double sumTime = 0.0;
+        for(std::size_t i = 0; i < sizes.size(); ++i)
+        {
+            double curve = complexityCurve(complexity, static_cast<double>(sizes[i]));
+            sumTimeCurve += times[i] * curve;
+            sumCurveCurve += curve * curve;
+            sumTime += times[i];
+        }
+        double coefficient = sumCurveCurve > 0.0 ? sumTimeCurve / sumCurveCurve : 0.0;
+
+        double sumSquares = 0.0;
+        for(std::size_t i = 0; i < sizes.size(); ++i)
         {
-            throw ActualConfirmException(std::to_string(expected), std::to_string(actual), location.line());
+            double residual = times[i] - coefficient * complexityCurve(complexity, static_cast<double>(sizes[i]));
+            sumSquares += residual * residual;
         }
+        double mean = sizes.empty() ? 0.0 : sumTime / static_cast<double>(sizes.size());
+        double rms = mean > 0.0 ? std::sqrt(sumSquares / static_cast<double>(sizes.size())) / mean : 0.0;
+        return {complexity, coefficient, rms};
     }
 
-    inline void confirm(double expected, double actual, const std::source_location location = std::source_location::current())
+    inline ComplexityFit bestComplexityFit(std::vector<std::size_t> const & sizes, std::vector<double> const & times)
     {
-        if (actual < (expected - 0.000001) || actual > (expected + 0.000001))
+        ComplexityFit best = fitComplexity(Complexity::O1, sizes, times);
+        for(Complexity complexity : {Complexity::OLOGN, Complexity::ON, Complexity::ON_LOGN, Complexity::ON2})
         {
-            throw ActualConfirmException(std::to_string(expected), std::to_string(actual), location.line());
+            ComplexityFit fit = fitComplexity(complexity, sizes, times);
+            if(fit.rms < best.rms)
+            {
+                best = fit;
+            }
         }
+        return best;
     }
 
-    inline void confirm(long double expected, long double actual, const std::source_location location = std::source_location::current())
+    //The expected curve is accepted when it is no worse than the best fit
+    //or when it still fits the timings within 10%.
+    inline bool confirmComplexity(Complexity expected, std::vector<std::size_t> const & sizes, std::vector<double> const & times, const std::source_location location = std::source_location::current(), ConfirmMode mode = ConfirmMode::Fatal)
     {
-        if (actual < (expected - 0.000001) || actual > (expected + 0.000001))
+        ComplexityFit best = bestComplexityFit(sizes, times);
+        if(best.complexity > expected && fitComplexity(expected, sizes, times).rms > 0.1)
         {
-            throw ActualConfirmException(std::to_string(expected), std::to_string(actual), location.line());
+            return failConfirm(ActualConfirmException(complexityName(expected), complexityName(best.complexity), location.line()), location, mode);
         }
+        return true;
     }
 
+    //Keeps the compiler from optimizing away a value a benchmark computes.
     template <typename T>
-    void confirm(T const & expected, T const & actual, const std::source_location location = std::source_location::current())
+    void doNotOptimize(T const & value)
     {
-        if (expected != actual)
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile char const * sink;
+        sink = reinterpret_cast<char const volatile *>(&value);
+#endif
+    }
+
+    //Runs runSize for from, from * multiplier, ... up to to and fits the
+    //timings to the complexity curves. Each size repeats until it has run
+    //for at least the minimum time so small sizes are not all noise.
+    class BenchmarkRange : public Test
+    {
+        public:
+            BenchmarkRange(std::string_view name, std::size_t from, std::size_t to, std::size_t multiplier, std::string_view suiteName = "") :
+            Test(name, suiteName),
+            mFrom(from < 1 ? 1 : from),
+            mTo(to),
+            mMultiplier(multiplier < 2 ? 2 : multiplier),
+            mHasExpected(false),
+            mExpected(Complexity::O1)
+            {}
+
+            virtual void runSize(std::size_t n) = 0;
+
+            void run() override
+            {
+                using Clock = std::chrono::steady_clock;
+                auto const minimum = std::chrono::milliseconds(1);
+                int const repetitions = 5;
+
+                mSizes.clear();
+                for(std::size_t n = mFrom; n <= mTo; n *= mMultiplier)
+                {
+                    mSizes.push_back(n);
+                    if(n > mTo / mMultiplier)
+                    {
+                        break;
+                    }
+                }
+
+                //Every repetition goes through all the sizes so a slow patch
+                //on the machine does not land on one size only. The fastest
+                //time for each size is kept.
+                mTimes.assign(mSizes.size(), 0.0);
+                for(int repetition = 0; repetition < repetitions; ++repetition)
+                {
+                    for(std::size_t i = 0; i < mSizes.size(); ++i)
+                    {
+                        std::size_t iterations = 0;
+                        auto start = Clock::now();
+                        auto elapsed = Clock::duration::zero();
+                        while(elapsed < minimum)
+                        {
+                            runSize(mSizes[i]);
+                            ++iterations;
+                            elapsed = Clock::now() - start;
+                        }
+                        double time = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+                        if(repetition == 0 || time < mTimes[i])
+                        {
+                            mTimes[i] = time;
+                        }
+                    }
+                }
+
+                mFit = bestComplexityFit(mSizes, mTimes);
+                std::string summary = "Complexity: ";
+                summary += complexityName(mFit.complexity);
+                summary += ", RMS error: " + std::to_string(static_cast<int>(mFit.rms * 100.0 + 0.5)) + "%";
+                setSummary(summary);
+
+                if(mHasExpected)
+                {
+                    confirmComplexity(mExpected, mSizes, mTimes, mExpectedLocation);
+                }
+            }
+
+            void setExpectedComplexity(Complexity expected, const std::source_location location = std::source_location::current())
+            {
+                mHasExpected = true;
+                mExpected = expected;
+                mExpectedLocation = location;
+            }
+
+            std::vector<std::size_t> const & getSizes() const { return mSizes; }
+            std::vector<double> const & getTimes() const { return mTimes; }
+            ComplexityFit const & getFit() const { return mFit; }
+
+        private:
+            std::size_t mFrom;
+            std::size_t mTo;
+            std::size_t mMultiplier;
+            bool mHasExpected;
+            Complexity mExpected;
+            std::source_location mExpectedLocation;
+            std::vector<std::size_t> mSizes;
+            std::vector<double> mTimes;
+            ComplexityFit mFit{};
+    };
+
+    template <typename... Types>
+    struct TypeList {};
+
+    //Name of a type in typed test names. Specialize it to give your own
+    //types a shorter name than the compiler's.
+    template <typename T>
+    struct TypeName
+    {
+        static std::string get()
+        {
+            //GCC and Clang spell the type out after "T = " in the function name.
+            std::string_view function = std::source_location::current().function_name();
+            std::size_t start = function.find("T = ");
+            if(start != std::string_view::npos)
+            {
+                start += 4;
+                std::size_t end = function.find_first_of(";]", start);
+                return std::string(function.substr(start, end - start));
+            }
+            start = function.find("TypeName<");
+            std::size_t end = function.rfind(">::get");
+            if(start != std::string_view::npos && end != std::string_view::npos && end > start)
+            {
+                start += 9;
+                return std::string(function.substr(start, end - start));
+            }
+            return std::string(function);
+        }
+    };
+
+#define SOURAVTDD_TYPE_NAME( type )\
+    template <>\
+    struct TypeName<type>\
+    {\
+        static std::string get() { return #type; }\
+    };
+    SOURAVTDD_TYPE_NAME(bool)
+    SOURAVTDD_TYPE_NAME(char)
+    SOURAVTDD_TYPE_NAME(float)
+    SOURAVTDD_TYPE_NAME(double)
+    SOURAVTDD_TYPE_NAME(long double)
+    SOURAVTDD_TYPE_NAME(std::int8_t)
+    SOURAVTDD_TYPE_NAME(std::int16_t)
+    SOURAVTDD_TYPE_NAME(std::int32_t)
+    SOURAVTDD_TYPE_NAME(std::int64_t)
+    SOURAVTDD_TYPE_NAME(std::uint8_t)
+    SOURAVTDD_TYPE_NAME(std::uint16_t)
+    SOURAVTDD_TYPE_NAME(std::uint32_t)
+    SOURAVTDD_TYPE_NAME(std::uint64_t)
+    SOURAVTDD_TYPE_NAME(std::string)
+#undef SOURAVTDD_TYPE_NAME
+
+    template <template <typename> class TestT, typename List>
+    class TypedTests;
+
+    //Creates and registers one test per type in the list. Each is named
+    //"name<type>" so it passes, fails and can be run on its own.
+    template <template <typename> class TestT, typename... Types>
+    class TypedTests<TestT, TypeList<Types...>>
+    {
+        public:
+            TypedTests(std::string_view name)
+            {
+                std::size_t index = 0;
+                (add<Types>(name, index++), ...);
+            }
+
+            std::size_t size() const { return sizeof...(Types); }
+
+        private:
+            template <typename T>
+            void add(std::string_view name, std::size_t index)
+            {
+                //Tests keep a view of their name, so it lives here.
+                mNames[index] = std::string(name) + "<" + TypeName<T>::get() + ">";
+                mTests[index] = std::make_unique<TestT<T>>(mNames[index]);
+            }
+
+            std::array<std::string, sizeof...(Types)> mNames;
+            std::array<std::unique_ptr<Test>, sizeof...(Types)> mTests;
+    };
+
+    //Appends a fixture's built state to a byte buffer. Each value is
+    //aligned for its type so FixtureReader can return arrays as spans into
+    //the mapped cache file without copying them.
+    class FixtureWriter
+    {
+        public:
+            template <typename U>
+            void write(U const & value)
+            {
+                writeArray(&value, 1, false);
+            }
+
+            template <typename U>
+            void writeArray(U const * values, std::size_t count)
+            {
+                writeArray(values, count, true);
+            }
+
+            void writeString(std::string_view text)
+            {
+                writeArray(text.data(), text.size());
+            }
+
+            std::string const & bytes() const { return mBytes; }
+
+        private:
+            template <typename U>
+            void writeArray(U const * values, std::size_t count, bool withCount)
+            {
+                static_assert(std::is_trivially_copyable_v<U>, "Cached fixture state must be trivially copyable.");
+                if(withCount)
+                {
+                    write(static_cast<std::uint64_t>(count));
+                }
+                mBytes.resize((mBytes.size() + alignof(U) - 1) / alignof(U) * alignof(U));
+                mBytes.append(reinterpret_cast<char const *>(values), sizeof(U) * count);
+            }
+
+            std::string mBytes;
+    };
+
+    //Reads state back in the order FixtureWriter wrote it. Arrays and
+    //strings point into the mapped file. Reading past the end returns empty
+    //values and makes ok() false.
+    class FixtureReader
+    {
+        public:
+            FixtureReader(char const * data, std::size_t size) : mData(data), mSize(size), mOffset(0), mOk(true) {}
+
+            template <typename U>
+            U read()
+            {
+                U value{};
+                std::span<U const> values = take<U>(1);
+                if(!values.empty())
+                {
+                    std::memcpy(&value, values.data(), sizeof(U));
+                }
+                return value;
+            }
+
+            template <typename U>
+            std::span<U const> readArray()
+            {
+                std::uint64_t count = read<std::uint64_t>();
+                return take<U>(count);
+            }
+
+            std::string_view readString()
+            {
+                std::span<char const> text = readArray<char>();
+                return std::string_view(text.data(), text.size());
+            }
+
+            bool ok() const { return mOk; }
+
+        private:
+            template <typename U>
+            std::span<U const> take(std::uint64_t count)
+            {
+                std::size_t start = (mOffset + alignof(U) - 1) / alignof(U) * alignof(U);
+                if(!mOk || start > mSize || count > (mSize - start) / sizeof(U))
+                {
+                    mOk = false;
+                    return {};
+                }
+                mOffset = start + sizeof(U) * count;
+                return std::span<U const>(reinterpret_cast<U const *>(mData + start), count);
+            }
+
+            char const * mData;
+            std::size_t mSize;
+            std::size_t mOffset;
+            bool mOk;
+    };
+
+    struct FixtureCacheHeader
+    {
+        char magic[8];
+        std::uint64_t keySize;
+        std::uint64_t dataOffset;
+        std::uint64_t dataSize;
+    };
+
+    inline constexpr char fixtureCacheMagic[8] = {'S', 'V', 'T', 'D', 'D', 'F', 'C', '1'};
+
+    //A cached fixture file mapped read only. The key it was written for is
+    //stored in the file, and open() fails when the file is missing, damaged
+    //or written for another key. The data starts on a 64 byte boundary.
+    class FixtureCacheFile
+    {
+        public:
+            FixtureCacheFile() : mMapping(nullptr), mMappingSize(0), mData(nullptr), mSize(0) {}
+            ~FixtureCacheFile() { close(); }
+            FixtureCacheFile(FixtureCacheFile const &) = delete;
+            FixtureCacheFile& operator=(FixtureCacheFile const &) = delete;
+
+            bool open(std::string const & path, std::string_view key)
+            {
+                close();
+#if SOURAVTDD_POSIX
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if(fd == -1)
+                {
+                    return false;
+                }
+                struct stat info{};
+                if(fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(FixtureCacheHeader)))
+                {
+                    ::close(fd);
+                    return false;
+                }
+                std::size_t size = static_cast<std::size_t>(info.st_size);
+                void* memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if(memory == MAP_FAILED)
+                {
+                    return false;
+                }
+
+                char const * bytes = static_cast<char const *>(memory);
+                FixtureCacheHeader header;
+                std::memcpy(&header, bytes, sizeof(header));
+                bool valid = std::memcmp(header.magic, fixtureCacheMagic, sizeof(fixtureCacheMagic)) == 0
+                    && header.keySize == key.size()
+                    && header.dataOffset >= sizeof(header) + header.keySize
+                    && header.dataOffset <= size
+                    && header.dataSize <= size - header.dataOffset
+                    && std::string_view(bytes + sizeof(header), key.size()) == key;
+                if(!valid)
+                {
+                    munmap(memory, size);
+                    return false;
+                }
+
+                mMapping = memory;
+                mMappingSize = size;
+                mData = bytes + header.dataOffset;
+                mSize = header.dataSize;
+                return true;
+#else
+                (void)path;
+                (void)key;
+                return false;
+#endif
+            }
+
+            void close()
+            {
+#if SOURAVTDD_POSIX
+                if(mMapping != nullptr)
+                {
+                    munmap(mMapping, mMappingSize);
+                }
+#endif
+                mMapping = nullptr;
+                mData = nullptr;
+                mSize = 0;
+            }
+
+            char const * data() const { return mData; }
+            std::size_t size() const { return mSize; }
+
+            //Writes to a temporary file and renames it over path, so a run
+            //that dies part way through never leaves a file that looks valid.
+            static bool store(std::string const & path, std::string_view key, std::string_view data)
+            {
+#if SOURAVTDD_POSIX
+                FixtureCacheHeader header{};
+                std::memcpy(header.magic, fixtureCacheMagic, sizeof(fixtureCacheMagic));
+                header.keySize = key.size();
+                header.dataOffset = (sizeof(header) + key.size() + 63) / 64 * 64;
+                header.dataSize = data.size();
+
+                std::string temporary = path + "." + std::to_string(getpid()) + ".tmp";
+                std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+                file.write(key.data(), static_cast<std::streamsize>(key.size()));
+                std::string padding(header.dataOffset - sizeof(header) - key.size(), '\0');
+                file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+                file.write(data.data(), static_cast<std::streamsize>(data.size()));
+                file.close();
+                if(!file || std::rename(temporary.c_str(), path.c_str()) != 0)
+                {
+                    std::remove(temporary.c_str());
+                    return false;
+                }
+                return true;
+#else
+                (void)path;
+                (void)key;
+                (void)data;
+                return false;
+#endif
+            }
+
+        private:
+            void* mMapping;
+            std::size_t mMappingSize;
+            char const * mData;
+            std::size_t mSize;
+    };
+
+    //A suite fixture whose built state can be cached on disk. cacheKey() is
+    //called before setup() and should name everything the state depends on,
+    //including a version to bump when the format changes. save() writes the
+    //built state and load() reads it back instead of running setup().
+    //tearDown() runs either way.
+    template <typename T>
+    concept CachedFixture = requires(T& fixture, T const & built, FixtureWriter& writer, FixtureReader& reader)
+    {
+        { built.cacheKey() } -> std::convertible_to<std::string>;
+        built.save(writer);
+        fixture.load(reader);
+    };
+
+    enum class FixtureCacheStatus
+    {
+        Loaded,
+        Stored,
+        NotStored
+    };
+
+    //Loads the fixture from the cache file at path when the file was written
+    //for its current key. Otherwise runs setup() and replaces the file.
+    //Whatever load() points at stays valid until cache is closed.
+    template <CachedFixture T>
+    FixtureCacheStatus setupCachedFixture(T& fixture, std::string const & path, FixtureCacheFile& cache)
+    {
+        std::string key = fixture.cacheKey();
+        if(cache.open(path, key))
+        {
+            FixtureReader reader(cache.data(), cache.size());
+            fixture.load(reader);
+            if(reader.ok())
+            {
+                return FixtureCacheStatus::Loaded;
+            }
+            cache.close();
+        }
+
+        fixture.setup();
+        FixtureWriter writer;
+        fixture.save(writer);
+        if(!FixtureCacheFile::store(path, key, writer.bytes()))
         {
-            throw ActualConfirmException(std::to_string(expected), std::to_string(actual), location.line());
+            return FixtureCacheStatus::NotStored;
         }
+        return FixtureCacheStatus::Stored;
     }
 
     template <typename T>
@@ -471,8 +3801,52 @@ namespace SouravTDD
     {
         public:
             TestSuiteSetupAndTearDown(std::string_view name, std::string_view suiteName) : TestSuite(name, suiteName) {}
-            void suiteSetup() override { T::setup(); }
-            void suiteTeardown() override { T::tearDown(); }  
+
+            void suiteSetup() override
+            {
+                mLoadedFromCache = false;
+                if constexpr (CachedFixture<T>)
+                {
+                    std::string const & dir = getFixtureCacheDir();
+                    if(!dir.empty())
+                    {
+                        if(!makeDirectories(dir))
+                        {
+                            setSummary("Fixture cache directory cannot be created: " + dir);
+                            T::setup();
+                            return;
+                        }
+                        std::string path = dir + "/" + getFileName(getQualifiedName(this)) + ".fixture";
+                        switch(setupCachedFixture<T>(*this, path, mCache))
+                        {
+                            case FixtureCacheStatus::Loaded:
+                                mLoadedFromCache = true;
+                                setSummary("Fixture loaded from cache: " + path);
+                                break;
+                            case FixtureCacheStatus::Stored:
+                                setSummary("Fixture saved to cache: " + path);
+                                break;
+                            case FixtureCacheStatus::NotStored:
+                                setSummary("Fixture cache file cannot be written: " + path);
+                                break;
+                        }
+                        return;
+                    }
+                }
+                T::setup();
+            }
+
+            void suiteTeardown() override
+            {
+                T::tearDown();
+                mCache.close();
+            }
+
+            bool loadedFromCache() const { return mLoadedFromCache; }
+
+        private:
+            FixtureCacheFile mCache;
+            bool mLoadedFromCache = false;
     };
 }
 
@@ -496,6 +3870,7 @@ namespace\
 SOURAVTDD_CLASS SOURAVTDD_INSTANCE (testName); \
 void SOURAVTDD_CLASS::run()
 
+#if SOURAVTDD_EXCEPTIONS
 #define TEST_EX(testName, exceptionType) \
 namespace\
 {\
@@ -509,6 +3884,7 @@ namespace\
 }\
 SOURAVTDD_CLASS SOURAVTDD_INSTANCE (testName, #exceptionType); \
 void SOURAVTDD_CLASS::run()
+#endif
 
 #define TEST_SUITE(testName, suiteName) \
 namespace\
@@ -524,6 +3900,7 @@ namespace\
 SOURAVTDD_CLASS SOURAVTDD_INSTANCE (testName, suiteName); \
 void SOURAVTDD_CLASS::run()
 
+#if SOURAVTDD_EXCEPTIONS
 #define TEST_SUITE_EX(testName, suiteName, exceptionType) \
 namespace\
 {\
@@ -537,11 +3914,132 @@ namespace\
 }\
 SOURAVTDD_CLASS SOURAVTDD_INSTANCE (testName, suiteName, #exceptionType); \
 void SOURAVTDD_CLASS::run()
+#endif
+
+#define SUITE_DEPENDS_ON(suiteName, upstreamSuiteName) \
+namespace\
+{\
+    SouravTDD::SuiteDependency SOURAVTDD_INSTANCE (suiteName, upstreamSuiteName); \
+}
+
+#define SUITE_RESOURCE(suiteName, resourceName) \
+namespace\
+{\
+    SouravTDD::SuiteResource SOURAVTDD_INSTANCE (suiteName, resourceName); \
+}
+
+//The type list is the last argument so its commas need no parentheses.
+//TypeParam names the current type in the body.
+#define TYPED_TEST(testName, ...) \
+namespace\
+{\
+    using SouravTDD::TypeList;\
+    template <typename TypeParam> \
+    class SOURAVTDD_CLASS : public SouravTDD::Test \
+    {\
+        public: \
+            SOURAVTDD_CLASS (std::string_view name) : SouravTDD::Test(name) \
+            {}\
+            void run() override;\
+    }; \
+}\
+SouravTDD::TypedTests<SOURAVTDD_CLASS, __VA_ARGS__> SOURAVTDD_INSTANCE (testName); \
+template <typename TypeParam> \
+void SOURAVTDD_CLASS<TypeParam>::run()
+
+//The body runs once per size with the size in n.
+#define BENCHMARK_RANGE(testName, from, to, multiplier) \
+namespace\
+{\
+    class SOURAVTDD_CLASS : public SouravTDD::BenchmarkRange \
+    {\
+        public: \
+            SOURAVTDD_CLASS (std::string_view name) : BenchmarkRange(name, from, to, multiplier) \
+            {}\
+            void runSize(std::size_t n) override;\
+    }; \
+}\
+SOURAVTDD_CLASS SOURAVTDD_INSTANCE (testName); \
+void SOURAVTDD_CLASS::runSize(std::size_t n)
 
+#if SOURAVTDD_EXCEPTIONS
+#define SOURAVTDD_FATAL( confirmation )\
+confirmation
+#else
+#define SOURAVTDD_FATAL( confirmation )\
+do { if(!(confirmation)) return; } while(false)
+#endif
 #define CONFIRM_FALSE( actual )\
-SouravTDD::confirm(false, actual)
+SOURAVTDD_FATAL(SouravTDD::confirm(false, actual))
 #define CONFIRM_TRUE( actual )\
-SouravTDD::confirm(true, actual)
+SOURAVTDD_FATAL(SouravTDD::confirm(true, actual))
 #define CONFIRM(expected, actual)\
-SouravTDD::confirm(expected, actual)
+SOURAVTDD_FATAL(SouravTDD::confirm(expected, actual))
+#define CHECK_FALSE( actual )\
+SouravTDD::check(false, actual)
+#define CHECK_TRUE( actual )\
+SouravTDD::check(true, actual)
+#define CHECK(expected, actual)\
+SouravTDD::check(expected, actual)
+
+#define CONFIRM_BYTES(expected, actual)\
+SOURAVTDD_FATAL(SouravTDD::confirmBytes(SouravTDD::asBytes(expected), SouravTDD::asBytes(actual)))
+#define CONFIRM_TEXT(expected, actual)\
+SOURAVTDD_FATAL(SouravTDD::confirmText(expected, actual))
+#define CHECK_BYTES(expected, actual)\
+SouravTDD::confirmBytes(SouravTDD::asBytes(expected), SouravTDD::asBytes(actual), std::source_location::current(), SouravTDD::ConfirmMode::Soft)
+#define CHECK_TEXT(expected, actual)\
+SouravTDD::confirmText(expected, actual, std::source_location::current(), SouravTDD::ConfirmMode::Soft)
+
+//Inside BENCHMARK_RANGE. Checked once every size has run.
+#define CONFIRM_COMPLEXITY( complexity )\
+setExpectedComplexity(SouravTDD::Complexity::complexity)
+
+#define CONFIRM_CALLS(mock, count)\
+SOURAVTDD_FATAL(SouravTDD::confirmCalls(mock, count))
+#define CONFIRM_CALLED_WITH(mock, ...)\
+SOURAVTDD_FATAL(SouravTDD::confirmCalledWith(std::source_location::current(), SouravTDD::ConfirmMode::Fatal, mock, __VA_ARGS__))
+#define CONFIRM_CALLED_BEFORE(first, second)\
+SOURAVTDD_FATAL(SouravTDD::confirmCalledBefore(first, second))
+#define CHECK_CALLS(mock, count)\
+SouravTDD::confirmCalls(mock, count, std::source_location::current(), SouravTDD::ConfirmMode::Soft)
+#define CHECK_CALLED_WITH(mock, ...)\
+SouravTDD::confirmCalledWith(std::source_location::current(), SouravTDD::ConfirmMode::Soft, mock, __VA_ARGS__)
+#define CHECK_CALLED_BEFORE(first, second)\
+SouravTDD::confirmCalledBefore(first, second, std::source_location::current(), SouravTDD::ConfirmMode::Soft)
+
+//MOCK_METHOD(returnType, methodName, argTypes...) overrides a virtual
+//method and forwards to a MockFunction member named mock_methodName.
+//Up to 6 arguments are supported. Wrap types containing commas in an alias.
+//MOCK_CONST_METHOD overrides a const method. MOCK_QUALIFIED_METHOD takes
+//the qualifiers in parentheses first, as in (const noexcept).
+#define SOURAVTDD_ARG_COUNT_FINAL(_0, _1, _2, _3, _4, _5, _6, count, ...) count
+#define SOURAVTDD_ARG_COUNT(...) SOURAVTDD_ARG_COUNT_FINAL(0 __VA_OPT__(,) __VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define SOURAVTDD_MOCK_PARAMS_0()
+#define SOURAVTDD_MOCK_PARAMS_1(T1) T1 a1
+#define SOURAVTDD_MOCK_PARAMS_2(T1, T2) T1 a1, T2 a2
+#define SOURAVTDD_MOCK_PARAMS_3(T1, T2, T3) T1 a1, T2 a2, T3 a3
+#define SOURAVTDD_MOCK_PARAMS_4(T1, T2, T3, T4) T1 a1, T2 a2, T3 a3, T4 a4
+#define SOURAVTDD_MOCK_PARAMS_5(T1, T2, T3, T4, T5) T1 a1, T2 a2, T3 a3, T4 a4, T5 a5
+#define SOURAVTDD_MOCK_PARAMS_6(T1, T2, T3, T4, T5, T6) T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6
+#define SOURAVTDD_MOCK_ARGS_0()
+#define SOURAVTDD_MOCK_ARGS_1(T1) std::forward<T1>(a1)
+#define SOURAVTDD_MOCK_ARGS_2(T1, T2) std::forward<T1>(a1), std::forward<T2>(a2)
+#define SOURAVTDD_MOCK_ARGS_3(T1, T2, T3) std::forward<T1>(a1), std::forward<T2>(a2), std::forward<T3>(a3)
+#define SOURAVTDD_MOCK_ARGS_4(T1, T2, T3, T4) std::forward<T1>(a1), std::forward<T2>(a2), std::forward<T3>(a3), std::forward<T4>(a4)
+#define SOURAVTDD_MOCK_ARGS_5(T1, T2, T3, T4, T5) std::forward<T1>(a1), std::forward<T2>(a2), std::forward<T3>(a3), std::forward<T4>(a4), std::forward<T5>(a5)
+#define SOURAVTDD_MOCK_ARGS_6(T1, T2, T3, T4, T5, T6) std::forward<T1>(a1), std::forward<T2>(a2), std::forward<T3>(a3), std::forward<T4>(a4), std::forward<T5>(a5), std::forward<T6>(a6)
+#define SOURAVTDD_MOCK_SELECT_FINAL(prefix, count) prefix ## count
+#define SOURAVTDD_MOCK_SELECT(prefix, count) SOURAVTDD_MOCK_SELECT_FINAL(prefix, count)
+#define SOURAVTDD_MOCK_UNWRAP(...) __VA_ARGS__
+#define MOCK_QUALIFIED_METHOD(qualifiers, returnType, methodName, ...) \
+mutable SouravTDD::MockFunction<returnType(__VA_ARGS__)> mock_ ## methodName {#methodName}; \
+returnType methodName(SOURAVTDD_MOCK_SELECT(SOURAVTDD_MOCK_PARAMS_, SOURAVTDD_ARG_COUNT(__VA_ARGS__))(__VA_ARGS__)) SOURAVTDD_MOCK_UNWRAP qualifiers override \
+{\
+    return mock_ ## methodName(SOURAVTDD_MOCK_SELECT(SOURAVTDD_MOCK_ARGS_, SOURAVTDD_ARG_COUNT(__VA_ARGS__))(__VA_ARGS__)); \
+}
+#define MOCK_METHOD(returnType, methodName, ...) \
+MOCK_QUALIFIED_METHOD((), returnType, methodName __VA_OPT__(,) __VA_ARGS__)
+#define MOCK_CONST_METHOD(returnType, methodName, ...) \
+MOCK_QUALIFIED_METHOD((const), returnType, methodName __VA_OPT__(,) __VA_ARGS__)
 #endif //SOURAVTDD_TEST_H
\ No newline at end of file
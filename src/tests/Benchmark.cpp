@@ -0,0 +1,85 @@
+/*
+  _________                                 _________ .__            __    __                 __               
+ /   _____/ ____  __ ______________ ___  __ \_   ___ \|  |__ _____ _/  |__/  |_  ___________ |__| ____   ____  
+ \_____  \ /  _ \|  |  \_  __ \__  \\  \/ / /    \  \/|  |  \\__  \\   __\   __\/ __ \_  __ \|  |/ __ \_/ __ \ 
+ /        (  <_> )  |  /|  | \// __ \\   /  \     \___|   Y  \/ __ \|  |  |  | \  ___/|  | \/|  \  ___/\  ___/ 
+/_______  /\____/|____/ |__|  (____  /\_/    \______  /___|  (____  /__|  |__|  \___  >__/\__|  |\___  >\___  >
+        \/                         \/               \/     \/     \/                \/   \______|    \/     \/ 
+
+ * Copyright (c) 2024 Sourav Chatterjee
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Test.h"
+#include <vector>
+
+long long sumTo(std::size_t n)
+{
+    long long sum = 0;
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        sum += static_cast<long long>(i);
+        SouravTDD::doNotOptimize(sum);
+    }
+    return sum;
+}
+
+TEST("Test complexity fit picks the matching curve")
+{
+    std::vector<std::size_t> sizes {8, 16, 32, 64, 128, 256};
+    std::vector<double> linear;
+    std::vector<double> quadratic;
+    for(std::size_t n : sizes)
+    {
+        linear.push_back(3.0 * n);
+        quadratic.push_back(0.5 * n * n);
+    }
+    CONFIRM_TRUE(SouravTDD::Complexity::ON == SouravTDD::bestComplexityFit(sizes, linear).complexity);
+    CONFIRM_TRUE(SouravTDD::Complexity::ON2 == SouravTDD::bestComplexityFit(sizes, quadratic).complexity);
+    CONFIRM(3.0, SouravTDD::fitComplexity(SouravTDD::Complexity::ON, sizes, linear).coefficient);
+    CONFIRM(0.0, SouravTDD::fitComplexity(SouravTDD::Complexity::ON, sizes, linear).rms);
+}
+
+TEST("Test complexity confirm rejects a worse curve")
+{
+    std::string reason = "Expected: O(n)\n";
+    reason += "Actual: O(n^2)";
+    setExpectedFailureReason(reason);
+    std::vector<std::size_t> sizes {64, 128, 256, 512, 1024};
+    std::vector<double> linear;
+    std::vector<double> quadratic;
+    for(std::size_t n : sizes)
+    {
+        //Small noise on the linear timings stays within the 10% allowed.
+        linear.push_back(2.0 * n * (n % 256 == 0 ? 1.05 : 1.0));
+        quadratic.push_back(0.25 * n * n);
+    }
+    CONFIRM_TRUE(SouravTDD::confirmComplexity(SouravTDD::Complexity::ON, sizes, linear));
+    CONFIRM_TRUE(SouravTDD::confirmComplexity(SouravTDD::Complexity::ON2, sizes, quadratic));
+    SouravTDD::confirmComplexity(SouravTDD::Complexity::ON, sizes, quadratic, std::source_location::current(), SouravTDD::ConfirmMode::Soft);
+}
+
+//Real timings vary from machine to machine, so this only checks a loose
+//upper bound. The fitting itself is covered by the synthetic tests above.
+BENCHMARK_RANGE("Test linear benchmark range", 1 << 10, 1 << 18, 4)
+{
+    SouravTDD::doNotOptimize(sumTo(n));
+    CONFIRM_COMPLEXITY(ON_LOGN);
+}
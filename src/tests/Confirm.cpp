@@ -28,6 +28,9 @@
  */
 
 #include "Test.h"
+#include <cstdint>
+#include <string>
+#include <vector>
 
 bool isNegative(int number)
 {
@@ -174,4 +177,90 @@ TEST("Test long double confirms")
     long double sum = ld1 + ld2;
     long double expected = 0.3L;
     CONFIRM(expected, sum);
-}
\ No newline at end of file
+}
+
+TEST("Test check confirms")
+{
+    CHECK_FALSE(isNegative(0));
+    CHECK_TRUE(isNegative(-1));
+    CHECK(2LL, multiplyBy2(1));
+    CHECK("abc", std::string("abc"));
+}
+
+TEST("Test check failure does not stop the test")
+{
+    std::string reason = "Expected: 0\n";
+    reason += "Actual: 2";
+    setExpectedFailureReason(reason);
+    int result = multiplyBy2(1);
+    CHECK(0, result);
+    CONFIRM(static_cast<std::size_t>(1), getFailures().size());
+}
+
+TEST("Test check failures accumulate")
+{
+    std::string reason = "Expected: true\n";
+    reason += "Expected: 0\n";
+    reason += "Actual: 2\n";
+    reason += "Expected: def\n";
+    reason += "Actual: abc";
+    setExpectedFailureReason(reason);
+    CHECK_TRUE(isNegative(0));
+    CHECK(0LL, multiplyBy2(1));
+    CHECK(std::string("def"), std::string("abc"));
+}
+
+TEST("Test byte and text confirms")
+{
+    std::vector<std::uint32_t> expected(1'000'000, 7);
+    std::vector<std::uint32_t> actual = expected;
+    CONFIRM_BYTES(expected, actual);
+    CONFIRM_BYTES("abc", std::string("abc"));
+    CONFIRM_TEXT(std::string(100'000, 'x'), std::string(100'000, 'x'));
+}
+
+TEST("Test byte confirm failure reports a window")
+{
+    std::string reason = "Bytes differ at offset 3000001. Expected 4000000 bytes, actual 4000000.\n";
+    reason += "Expected: @2999993: 00 00 00 00 00 00 00 00 [00] 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 ...\n";
+    reason += "Actual:   @2999993: 00 00 00 00 00 00 00 00 [ff] 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 ...";
+    setExpectedFailureReason(reason);
+    std::vector<unsigned char> expected(4'000'000, 0);
+    std::vector<unsigned char> actual = expected;
+    actual[3'000'001] = 0xff;
+    CONFIRM_BYTES(expected, actual);
+}
+
+TEST("Test byte confirm failure reports the shorter end")
+{
+    std::string reason = "Bytes differ at offset 3. Expected 3 bytes, actual 4.\n";
+    reason += "Expected: @0: 61 62 63 [end]\n";
+    reason += "Actual:   @0: 61 62 63 [0a]";
+    setExpectedFailureReason(reason);
+    CONFIRM_BYTES("abc", "abc\n");
+}
+
+TEST("Test text confirm failure marks the difference")
+{
+    std::string reason = "Text differs at offset 9, line 2, column 4. Expected 14 chars, actual 14.\n";
+    reason += "Expected: first\\nsecond\\tx\n";
+    reason += "Actual:   first\\nsecOnd\\tx\n";
+    reason += "                    ^";
+    setExpectedFailureReason(reason);
+    CONFIRM_TEXT("first\nsecond\tx", "first\nsecOnd\tx");
+}
+
+TEST("Test long string confirm failure is bounded")
+{
+    std::string expected(50'000, 'a');
+    std::string actual = expected;
+    actual[25'000] = 'b';
+    std::string before(32, 'a');
+    std::string after(31, 'a');
+    std::string reason = "Text differs at offset 25000, line 1, column 25001. Expected 50000 chars, actual 50000.\n";
+    reason += "Expected: ..." + before + "a" + after + "...\n";
+    reason += "Actual:   ..." + before + "b" + after + "...\n";
+    reason += std::string(45, ' ') + "^";
+    setExpectedFailureReason(reason);
+    CONFIRM(expected, actual);
+}
@@ -32,6 +32,8 @@
 TEST("Test can be created")
 {
 }
+
+#if SOURAVTDD_EXCEPTIONS
 TEST_EX("Test with throw can be created", int)
 {
     throw 1;
@@ -63,4 +65,5 @@ TEST_EX("Test that throws wrong type can be created", int)
 TEST("Test that should throw unexpectedly can be created")
 {
     setExpectedFailureReason("Unexpected exception thrown.");
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+/*
+  _________                                 _________ .__            __    __                 __               
+ /   _____/ ____  __ ______________ ___  __ \_   ___ \|  |__ _____ _/  |__/  |_  ___________ |__| ____   ____  
+ \_____  \ /  _ \|  |  \_  __ \__  \\  \/ / /    \  \/|  |  \\__  \\   __\   __\/ __ \_  __ \|  |/ __ \_/ __ \ 
+ /        (  <_> )  |  /|  | \// __ \\   /  \     \___|   Y  \/ __ \|  |  |  | \  ___/|  | \/|  \  ___/\  ___/ 
+/_______  /\____/|____/ |__|  (____  /\_/    \______  /___|  (____  /__|  |__|  \___  >__/\__|  |\___  >\___  >
+        \/                         \/               \/     \/     \/                \/   \______|    \/     \/ 
+
+ * Copyright (c) 2024 Sourav Chatterjee
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Test.h"
+#include <cstdio>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace
+{
+    int gPrimeTableBuilds = 0;
+}
+
+//Stands in for an expensive immutable dataset. The primes are built once
+//and later runs map them back from the fixture cache.
+class PrimeTable
+{
+    public:
+        std::string cacheKey() const
+        {
+            return "primes v1 limit=" + std::to_string(mLimit);
+        }
+
+        void setup()
+        {
+            ++gPrimeTableBuilds;
+            std::vector<bool> composite(mLimit + 1, false);
+            for(int i = 2; i <= mLimit; ++i)
+            {
+                if(!composite[i])
+                {
+                    mStorage.push_back(i);
+                    for(long long j = static_cast<long long>(i) * i; j <= mLimit; j += i)
+                    {
+                        composite[j] = true;
+                    }
+                }
+            }
+            mPrimes = mStorage;
+        }
+
+        void save(SouravTDD::FixtureWriter& writer) const
+        {
+            writer.writeString("primes");
+            writer.writeArray(mPrimes.data(), mPrimes.size());
+        }
+
+        void load(SouravTDD::FixtureReader& reader)
+        {
+            mLabel = reader.readString();
+            mPrimes = reader.readArray<int>();
+        }
+
+        void tearDown()
+        {
+            mStorage.clear();
+            mPrimes = {};
+        }
+
+        std::span<int const> getPrimes() const { return mPrimes; }
+        std::string_view getLabel() const { return mLabel; }
+        void setLimit(int limit) { mLimit = limit; }
+
+    private:
+        int mLimit = 100000;
+        std::vector<int> mStorage;
+        std::span<int const> mPrimes;
+        std::string_view mLabel;
+};
+
+SouravTDD::TestSuiteSetupAndTearDown<PrimeTable> gPrimes("Prime table", "Fixture cache");
+
+TEST_SUITE("Test cached suite fixture has its state", "Fixture cache")
+{
+    CONFIRM(9592, static_cast<int>(gPrimes.getPrimes().size()));
+    CONFIRM(2, gPrimes.getPrimes().front());
+    CONFIRM(99991, gPrimes.getPrimes().back());
+}
+
+TEST("Test cached fixture is built once and then mapped back")
+{
+    std::string path = "souravtdd_fixture_test.tmp";
+    std::remove(path.c_str());
+    int buildsBefore = gPrimeTableBuilds;
+    {
+        PrimeTable table;
+        table.setLimit(1000);
+        SouravTDD::FixtureCacheFile cache;
+        SouravTDD::FixtureCacheStatus expected = SOURAVTDD_POSIX ? SouravTDD::FixtureCacheStatus::Stored : SouravTDD::FixtureCacheStatus::NotStored;
+        CONFIRM_TRUE(SouravTDD::setupCachedFixture(table, path, cache) == expected);
+        CONFIRM(168, static_cast<int>(table.getPrimes().size()));
+        table.tearDown();
+    }
+    CONFIRM(buildsBefore + 1, gPrimeTableBuilds);
+
+#if SOURAVTDD_POSIX
+    {
+        PrimeTable table;
+        table.setLimit(1000);
+        SouravTDD::FixtureCacheFile cache;
+        CONFIRM_TRUE(SouravTDD::setupCachedFixture(table, path, cache) == SouravTDD::FixtureCacheStatus::Loaded);
+        CONFIRM(buildsBefore + 1, gPrimeTableBuilds);
+        CONFIRM("primes", table.getLabel());
+        CONFIRM(168, static_cast<int>(table.getPrimes().size()));
+        CONFIRM(997, table.getPrimes().back());
+        //The primes are read from the mapping, not copied out of it.
+        char const * first = reinterpret_cast<char const *>(table.getPrimes().data());
+        CONFIRM_TRUE(first >= cache.data() && first < cache.data() + cache.size());
+        table.tearDown();
+    }
+
+    {
+        //A new key makes the cached state stale.
+        PrimeTable table;
+        table.setLimit(2000);
+        SouravTDD::FixtureCacheFile cache;
+        CONFIRM_TRUE(SouravTDD::setupCachedFixture(table, path, cache) == SouravTDD::FixtureCacheStatus::Stored);
+        CONFIRM(buildsBefore + 2, gPrimeTableBuilds);
+        CONFIRM(303, static_cast<int>(table.getPrimes().size()));
+        table.tearDown();
+    }
+#endif
+    std::remove(path.c_str());
+}
+
+TEST("Test fixture cache reports a file it cannot write")
+{
+    PrimeTable table;
+    table.setLimit(100);
+    SouravTDD::FixtureCacheFile cache;
+    CONFIRM_TRUE(SouravTDD::setupCachedFixture(table, "souravtdd_missing_dir.tmp/primes.fixture", cache) == SouravTDD::FixtureCacheStatus::NotStored);
+    CONFIRM(25, static_cast<int>(table.getPrimes().size()));
+    table.tearDown();
+}
+
+TEST("Test fixture cache directories are created with their parents")
+{
+#if SOURAVTDD_POSIX
+    CONFIRM_TRUE(SouravTDD::makeDirectories("souravtdd_dirs.tmp/nested/cache"));
+    CONFIRM_TRUE(SouravTDD::makeDirectories("souravtdd_dirs.tmp/nested/cache"));
+    std::ofstream("souravtdd_dirs.tmp/file").put('x');
+    CONFIRM_FALSE(SouravTDD::makeDirectories("souravtdd_dirs.tmp/file/cache"));
+    std::remove("souravtdd_dirs.tmp/file");
+    rmdir("souravtdd_dirs.tmp/nested/cache");
+    rmdir("souravtdd_dirs.tmp/nested");
+    rmdir("souravtdd_dirs.tmp");
+#endif
+}
+
+TEST("Test fixture reader stops at the end of the data")
+{
+    SouravTDD::FixtureWriter writer;
+    writer.write(std::uint16_t(7));
+    double values[] = {1.5, 2.5};
+    writer.writeArray(values, 2);
+
+    SouravTDD::FixtureReader reader(writer.bytes().data(), writer.bytes().size());
+    CONFIRM(7, static_cast<int>(reader.read<std::uint16_t>()));
+    std::span<double const> read = reader.readArray<double>();
+    CONFIRM(2, static_cast<int>(read.size()));
+    CONFIRM(2.5, read[1]);
+    CONFIRM_TRUE(reader.ok());
+    CONFIRM_TRUE(reader.readArray<int>().empty());
+    CONFIRM_FALSE(reader.ok());
+}
@@ -0,0 +1,179 @@
+/*
+  _________                                 _________ .__            __    __                 __               
+ /   _____/ ____  __ ______________ ___  __ \_   ___ \|  |__ _____ _/  |__/  |_  ___________ |__| ____   ____  
+ \_____  \ /  _ \|  |  \_  __ \__  \\  \/ / /    \  \/|  |  \\__  \\   __\   __\/ __ \_  __ \|  |/ __ \_/ __ \ 
+ /        (  <_> )  |  /|  | \// __ \\   /  \     \___|   Y  \/ __ \|  |  |  | \  ___/|  | \/|  \  ___/\  ___/ 
+/_______  /\____/|____/ |__|  (____  /\_/    \______  /___|  (____  /__|  |__|  \___  >__/\__|  |\___  >\___  >
+        \/                         \/               \/     \/     \/                \/   \______|    \/     \/ 
+
+ * Copyright (c) 2024 Sourav Chatterjee
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Test.h"
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <vector>
+#include <string>
+
+TEST("Test qualified names include the suite")
+{
+    CONFIRM("Test qualified names include the suite", SouravTDD::getQualifiedName(this));
+}
+
+TEST_SUITE("Test qualified suite name", "Suite 1")
+{
+    CONFIRM("Suite 1/Test qualified suite name", SouravTDD::getQualifiedName(this));
+}
+
+TEST("Test flaky history can be saved and loaded")
+{
+    std::string path = "souravtdd_flaky_history.tmp";
+    std::map<std::string, SouravTDD::FlakyRecord> history;
+    history["Suite 1/Test with spaces"] = {10, 2, 3};
+    history["Single"] = {1, 0, 0};
+    SouravTDD::saveFlakyHistory(path, history);
+
+    auto loaded = SouravTDD::loadFlakyHistory(path);
+    std::remove(path.c_str());
+    CONFIRM(static_cast<std::size_t>(2), loaded.size());
+    CONFIRM(10, loaded["Suite 1/Test with spaces"].runs);
+    CONFIRM(2, loaded["Suite 1/Test with spaces"].failures);
+    CONFIRM(3, loaded["Suite 1/Test with spaces"].flaky);
+    CONFIRM(1, loaded["Single"].runs);
+}
+
+TEST("Test quarantine list skips comments and blank lines")
+{
+    std::string path = "souravtdd_quarantine.tmp";
+    {
+        std::ofstream file(path);
+        file << "# Known flaky\n\nSuite 1/Test part 1 of suite\nSingle test\n";
+    }
+    auto quarantine = SouravTDD::loadQuarantine(path);
+    std::remove(path.c_str());
+    CONFIRM(static_cast<std::size_t>(2), quarantine.size());
+    CONFIRM_TRUE(quarantine.contains("Suite 1/Test part 1 of suite"));
+    CONFIRM_TRUE(quarantine.contains("Single test"));
+}
+
+namespace
+{
+    //The retry suite only misbehaves while the driver below arms it, so
+    //its tests pass in a normal run.
+    bool gArmRetrySuite = false;
+    int gRetryFailuresLeft = 0;
+    int gRetrySetups = 0;
+}
+
+class RetryCounter
+{
+    public:
+        void setup()
+        {
+            ++gRetrySetups;
+        }
+
+        void tearDown()
+        {
+        }
+};
+
+SouravTDD::TestSuiteSetupAndTearDown<RetryCounter> gRetryCounter("Retry counter", "Retry");
+
+TEST_SUITE("Test fails once", "Retry")
+{
+    if(gRetryFailuresLeft > 0)
+    {
+        --gRetryFailuresLeft;
+        CONFIRM_TRUE(false);
+    }
+}
+
+TEST_SUITE("Test fails while armed", "Retry")
+{
+    CONFIRM_FALSE(gArmRetrySuite);
+}
+
+TEST_SUITE("Test passes", "Retry")
+{
+}
+
+class RetryDriver
+{
+    public:
+        void setup()
+        {
+        }
+
+        void tearDown()
+        {
+        }
+};
+
+SouravTDD::TestSuiteSetupAndTearDown<RetryDriver> gRetryDriver("Retry driver", "Retry driver");
+
+//Runs after the Retry suite so the two never share its tests.
+SUITE_DEPENDS_ON("Retry driver", "Retry")
+
+TEST_SUITE("Test retries classify flaky and quarantined failures", "Retry driver")
+{
+    std::vector<SouravTDD::Test*> tests = SouravTDD::getTests().at("Retry");
+    SouravTDD::RunOptions options;
+    options.captureOutput = false;
+    options.retries = 1;
+    std::set<std::string> quarantine = {"Retry/Test fails while armed"};
+
+    gArmRetrySuite = true;
+    gRetryFailuresLeft = 1;
+    gRetrySetups = 0;
+    std::ostringstream output;
+    std::vector<SouravTDD::Test*> failed;
+    SouravTDD::RunCounts counts;
+    bool setupPassed = SouravTDD::runSuiteTests(output, "Retry", tests, failed, counts, quarantine, options);
+
+    bool onceIsFlaky = false;
+    for(auto * test : tests)
+    {
+        if(test->getName() == "Test fails once")
+        {
+            onceIsFlaky = test->isFlaky();
+        }
+        test->reset();
+    }
+    gArmRetrySuite = false;
+
+    CONFIRM_TRUE(setupPassed);
+    CONFIRM_TRUE(onceIsFlaky);
+    //Setup and teardown count as passed along with the passing test.
+    CONFIRM(3, counts.passed);
+    CONFIRM(0, counts.failed);
+    CONFIRM(1, counts.flaky);
+    CONFIRM(1, counts.quarantined);
+    CONFIRM(static_cast<std::size_t>(1), failed.size());
+    CONFIRM("Test fails while armed", failed.front()->getName());
+    //One setup for the run and one for each retry.
+    CONFIRM(3, gRetrySetups);
+    std::string text = output.str();
+    CONFIRM_TRUE(text.find("FLAKY: Passed on retry") != std::string::npos);
+    CONFIRM_TRUE(text.find("Quarantined failure: Test fails while armed") != std::string::npos);
+}
@@ -0,0 +1,116 @@
+/*
+  _________                                 _________ .__            __    __                 __               
+ /   _____/ ____  __ ______________ ___  __ \_   ___ \|  |__ _____ _/  |__/  |_  ___________ |__| ____   ____  
+ \_____  \ /  _ \|  |  \_  __ \__  \\  \/ / /    \  \/|  |  \\__  \\   __\   __\/ __ \_  __ \|  |/ __ \_/ __ \ 
+ /        (  <_> )  |  /|  | \// __ \\   /  \     \___|   Y  \/ __ \|  |  |  | \  ___/|  | \/|  \  ___/\  ___/ 
+/_______  /\____/|____/ |__|  (____  /\_/    \______  /___|  (____  /__|  |__|  \___  >__/\__|  |\___  >\___  >
+        \/                         \/               \/     \/     \/                \/   \______|    \/     \/ 
+
+ * Copyright (c) 2024 Sourav Chatterjee
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Test.h"
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+TEST("Test flight recorder timeline can be decoded")
+{
+    std::string path = "souravtdd_flight_test.tmp";
+    {
+        SouravTDD::FlightRecorder recorder;
+#if SOURAVTDD_POSIX
+        CONFIRM_TRUE(recorder.open(path, 8));
+#endif
+        recorder.record(SouravTDD::FlightEvent::TestStart, "Suite/finished test");
+        recorder.record(SouravTDD::FlightEvent::Failure, "Suite/finished test\nExpected: true", 42);
+        recorder.record(SouravTDD::FlightEvent::TestEnd, "Suite/finished test", 0, 1500000);
+        recorder.record(SouravTDD::FlightEvent::TestStart, "Suite/killed test");
+    }
+
+    std::ostringstream timeline;
+    bool decoded = SouravTDD::decodeFlightRecorder(path, timeline);
+    std::remove(path.c_str());
+#if SOURAVTDD_POSIX
+    CONFIRM_TRUE(decoded);
+    std::string text = timeline.str();
+    CONFIRM_TRUE(text.find("Test started: Suite/finished test") != std::string::npos);
+    CONFIRM_TRUE(text.find("Failure in Suite/finished test on line 42: Expected: true") != std::string::npos);
+    CONFIRM_TRUE(text.find("Test failed: Suite/finished test (1.5 ms)") != std::string::npos);
+    CONFIRM_TRUE(text.find("Never finished: Test Suite/killed test") != std::string::npos);
+#else
+    CONFIRM_FALSE(decoded);
+#endif
+}
+
+TEST("Test flight recorder ring keeps the newest events")
+{
+    std::string path = "souravtdd_flight_ring.tmp";
+    {
+        SouravTDD::FlightRecorder recorder;
+        recorder.open(path, 4);
+        for(int i = 0; i < 10; ++i)
+        {
+            recorder.record(SouravTDD::FlightEvent::TestStart, "test " + std::to_string(i));
+            recorder.record(SouravTDD::FlightEvent::TestEnd, "test " + std::to_string(i), 1);
+        }
+    }
+
+    std::ostringstream timeline;
+    SouravTDD::decodeFlightRecorder(path, timeline);
+    std::remove(path.c_str());
+#if SOURAVTDD_POSIX
+    std::string text = timeline.str();
+    CONFIRM_TRUE(text.find("20 events, oldest 16 overwritten") != std::string::npos);
+    CONFIRM_TRUE(text.find("test 7") == std::string::npos);
+    CONFIRM_TRUE(text.find("Test passed: test 9") != std::string::npos);
+#endif
+}
+
+TEST("Test flight recorder file is locked by the process writing it")
+{
+    std::string path = "souravtdd_flight_lock.tmp";
+    SouravTDD::FlightRecorder first;
+    SouravTDD::FlightRecorder second;
+#if SOURAVTDD_POSIX
+    CONFIRM_TRUE(first.open(path, 4));
+    first.record(SouravTDD::FlightEvent::TestStart, "kept");
+    CONFIRM_FALSE(second.open(path, 4));
+    first.close();
+    std::ostringstream timeline;
+    SouravTDD::decodeFlightRecorder(path, timeline);
+    CONFIRM_TRUE(timeline.str().find("Test started: kept") != std::string::npos);
+    CONFIRM_TRUE(second.open(path, 4));
+    second.close();
+#endif
+    std::remove(path.c_str());
+}
+
+TEST("Test flight recorder path is named after the program")
+{
+    SouravTDD::RunOptions options;
+    options.program = "/build/bin/runner";
+    CONFIRM("runner_flight.bin", SouravTDD::getFlightRecorderPath(options));
+    options.program.clear();
+    CONFIRM("souravtdd_flight.bin", SouravTDD::getFlightRecorderPath(options));
+    options.flightRecorderFile = "logs/flight.bin";
+    CONFIRM("logs/flight.bin", SouravTDD::getFlightRecorderPath(options));
+}
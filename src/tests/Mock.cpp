@@ -0,0 +1,208 @@
+/*
+  _________                                 _________ .__            __    __                 __               
+ /   _____/ ____  __ ______________ ___  __ \_   ___ \|  |__ _____ _/  |__/  |_  ___________ |__| ____   ____  
+ \_____  \ /  _ \|  |  \_  __ \__  \\  \/ / /    \  \/|  |  \\__  \\   __\   __\/ __ \_  __ \|  |/ __ \_/ __ \ 
+ /        (  <_> )  |  /|  | \// __ \\   /  \     \___|   Y  \/ __ \|  |  |  | \  ___/|  | \/|  \  ___/\  ___/ 
+/_______  /\____/|____/ |__|  (____  /\_/    \______  /___|  (____  /__|  |__|  \___  >__/\__|  |\___  >\___  >
+        \/                         \/               \/     \/     \/                \/   \______|    \/     \/ 
+
+ * Copyright (c) 2024 Sourav Chatterjee
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Test.h"
+#include <memory>
+#include <string>
+
+class Channel
+{
+    public:
+        virtual ~Channel() = default;
+        virtual void open() = 0;
+        virtual int write(int id, std::string const & payload) = 0;
+        virtual void close() = 0;
+};
+
+class FakeChannel : public Channel
+{
+    public:
+        MOCK_METHOD(void, open);
+        MOCK_METHOD(int, write, int, std::string const &);
+        MOCK_METHOD(void, close);
+};
+
+int sendAll(Channel& channel, int count)
+{
+    channel.open();
+    int written = 0;
+    for(int i = 0; i < count; ++i)
+    {
+        written += channel.write(i, "payload");
+    }
+    channel.close();
+    return written;
+}
+
+TEST("Test mock records calls")
+{
+    FakeChannel channel;
+    channel.mock_write.returns(7);
+    int written = sendAll(channel, 3);
+    CONFIRM(21, written);
+    CONFIRM_CALLS(channel.mock_open, 1);
+    CONFIRM_CALLS(channel.mock_write, 3);
+    CONFIRM_CALLED_WITH(channel.mock_write, 2, "payload");
+    CONFIRM_CALLED_WITH(channel.mock_write, SouravTDD::anything, [](std::string const & payload) { return !payload.empty(); });
+    CONFIRM_CALLED_BEFORE(channel.mock_open, channel.mock_write);
+    CONFIRM_CALLED_BEFORE(channel.mock_write, channel.mock_close);
+}
+
+TEST("Test mock invokes action")
+{
+    FakeChannel channel;
+    channel.mock_write.invokes([](int id, std::string const & payload)
+    {
+        return id + static_cast<int>(payload.size());
+    });
+    int written = sendAll(channel, 2);
+    CONFIRM(15, written);
+}
+
+TEST("Test mock ring buffer keeps the latest calls")
+{
+    SouravTDD::MockFunction<void(int)> sink("sink", 4);
+    for(int i = 0; i < 10; ++i)
+    {
+        sink(i);
+    }
+    CONFIRM_CALLS(sink, 10);
+    CONFIRM(static_cast<std::size_t>(4), sink.retainedCount());
+    CONFIRM(6, std::get<0>(sink.call(0)));
+    CONFIRM(9, std::get<0>(sink.lastCall()));
+    CONFIRM_FALSE(sink.calledWith(5));
+}
+
+TEST("Test mock call count failure")
+{
+    std::string reason = "Expected: write called 4 times\n";
+    reason += "Actual: write called 3 times";
+    setExpectedFailureReason(reason);
+    FakeChannel channel;
+    sendAll(channel, 3);
+    CONFIRM_CALLS(channel.mock_write, 4);
+}
+
+TEST("Test mock argument and order failures")
+{
+    std::string reason = "Expected: write called with matching arguments\n";
+    reason += "Actual: write called 2 times without a match\n";
+    reason += "Expected: close called before open\n";
+    reason += "Actual: open called first";
+    setExpectedFailureReason(reason);
+    FakeChannel channel;
+    sendAll(channel, 2);
+    CHECK_CALLED_WITH(channel.mock_write, 5, SouravTDD::anything);
+    CHECK_CALLED_BEFORE(channel.mock_close, channel.mock_open);
+}
+
+TEST("Test mock order failure from a later call")
+{
+    std::string reason = "Expected: open called before close\n";
+    reason += "Actual: open called again after close";
+    setExpectedFailureReason(reason);
+    FakeChannel channel;
+    channel.open();
+    channel.write(1, "payload");
+    channel.close();
+    channel.open();
+    CHECK_CALLED_BEFORE(channel.mock_write, channel.mock_close);
+    CHECK_CALLED_BEFORE(channel.mock_open, channel.mock_close);
+}
+
+class Shape
+{
+    public:
+        virtual ~Shape() = default;
+        virtual int sides() const = 0;
+};
+
+class Square : public Shape
+{
+    public:
+        int sides() const override { return 4; }
+};
+
+class Canvas
+{
+    public:
+        virtual ~Canvas() = default;
+        virtual int size() const = 0;
+        virtual bool empty() const noexcept = 0;
+        virtual void draw(Shape const & shape) = 0;
+        virtual void take(std::unique_ptr<int> pixels, int count) = 0;
+};
+
+class FakeCanvas : public Canvas
+{
+    public:
+        MOCK_CONST_METHOD(int, size);
+        MOCK_QUALIFIED_METHOD((const noexcept), bool, empty);
+        MOCK_METHOD(void, draw, Shape const &);
+        MOCK_METHOD(void, take, std::unique_ptr<int>, int);
+};
+
+TEST("Test mock overrides const and noexcept methods")
+{
+    FakeCanvas fake;
+    fake.mock_size.returns(3);
+    fake.mock_empty.returns(true);
+    Canvas const & canvas = fake;
+    CONFIRM(3, canvas.size());
+    CONFIRM_TRUE(canvas.empty());
+    CONFIRM_CALLS(fake.mock_size, 1);
+    CONFIRM_CALLS(fake.mock_empty, 1);
+}
+
+TEST("Test mock keeps a pointer to an abstract argument")
+{
+    FakeCanvas fake;
+    Square square;
+    Canvas& canvas = fake;
+    canvas.draw(square);
+    CONFIRM_CALLS(fake.mock_draw, 1);
+    CONFIRM_TRUE(std::get<0>(fake.mock_draw.lastCall()) == &square);
+    CONFIRM_CALLED_WITH(fake.mock_draw, [](Shape const * shape) { return shape->sides() == 4; });
+}
+
+TEST("Test mock skips recording a move-only argument")
+{
+    FakeCanvas fake;
+    std::unique_ptr<int> taken;
+    fake.mock_take.invokes([&](std::unique_ptr<int> pixels, int)
+    {
+        taken = std::move(pixels);
+    });
+    Canvas& canvas = fake;
+    canvas.take(std::make_unique<int>(9), 2);
+    CONFIRM_CALLS(fake.mock_take, 1);
+    CONFIRM_CALLED_WITH(fake.mock_take, SouravTDD::anything, 2);
+    CONFIRM_TRUE(taken != nullptr);
+    CONFIRM(9, *taken);
+}
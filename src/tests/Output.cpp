@@ -0,0 +1,99 @@
+/*
+  _________                                 _________ .__            __    __                 __               
+ /   _____/ ____  __ ______________ ___  __ \_   ___ \|  |__ _____ _/  |__/  |_  ___________ |__| ____   ____  
+ \_____  \ /  _ \|  |  \_  __ \__  \\  \/ / /    \  \/|  |  \\__  \\   __\   __\/ __ \_  __ \|  |/ __ \_/ __ \ 
+ /        (  <_> )  |  /|  | \// __ \\   /  \     \___|   Y  \/ __ \|  |  |  | \  ___/|  | \/|  \  ___/\  ___/ 
+/_______  /\____/|____/ |__|  (____  /\_/    \______  /___|  (____  /__|  |__|  \___  >__/\__|  |\___  >\___  >
+        \/                         \/               \/     \/     \/                \/   \______|    \/     \/ 
+
+ * Copyright (c) 2024 Sourav Chatterjee
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Test.h"
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    bool gFailPrintingTest = false;
+}
+
+TEST("Test output capture collects stdout and stderr")
+{
+    SouravTDD::OutputCapture capture;
+    std::cout << "cout line\n";
+    std::cerr << "cerr line\n";
+    std::printf("printf line\n");
+    std::string captured = capture.finish();
+    //Parallel runs capture only the standard streams of this thread.
+    if(SouravTDD::ThreadStreamRouting::active())
+    {
+        CONFIRM("cout line\ncerr line\n", captured);
+        return;
+    }
+#if SOURAVTDD_POSIX
+    CONFIRM("cout line\ncerr line\nprintf line\n", captured);
+#else
+    CONFIRM("", captured);
+#endif
+}
+
+TEST("Test output from a passing test is not shown")
+{
+    std::cout << "This line is only shown with --verbose." << std::endl;
+    CONFIRM_FALSE(gFailPrintingTest);
+}
+
+TEST("Test captured output is shown with verbose or on failure")
+{
+    SouravTDD::Test* test = SouravTDD::findTest("Test output from a passing test is not shown");
+    CONFIRM_TRUE(test != nullptr);
+    std::string const line = "This line is only shown with --verbose.";
+    int passed = 0;
+    int failed = 0;
+    int missedFailed = 0;
+
+    SouravTDD::RunOptions options;
+    std::ostringstream quiet;
+    test->reset();
+    SouravTDD::runTest(quiet, test, passed, failed, missedFailed, options);
+
+    options.verbose = true;
+    std::ostringstream verbose;
+    test->reset();
+    SouravTDD::runTest(verbose, test, passed, failed, missedFailed, options);
+
+    options.verbose = false;
+    std::ostringstream failing;
+    gFailPrintingTest = true;
+    test->reset();
+    SouravTDD::runTest(failing, test, passed, failed, missedFailed, options);
+    gFailPrintingTest = false;
+    test->reset();
+
+    CONFIRM(2, passed);
+    CONFIRM(1, failed);
+    CONFIRM_TRUE(quiet.str().find(line) == std::string::npos);
+    CONFIRM_TRUE(verbose.str().find(line) != std::string::npos);
+    CONFIRM_TRUE(failing.str().find(line) != std::string::npos);
+}
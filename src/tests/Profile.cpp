@@ -0,0 +1,139 @@
+/*
+  _________                                 _________ .__            __    __                 __               
+ /   _____/ ____  __ ______________ ___  __ \_   ___ \|  |__ _____ _/  |__/  |_  ___________ |__| ____   ____  
+ \_____  \ /  _ \|  |  \_  __ \__  \\  \/ / /    \  \/|  |  \\__  \\   __\   __\/ __ \_  __ \|  |/ __ \_/ __ \ 
+ /        (  <_> )  |  /|  | \// __ \\   /  \     \___|   Y  \/ __ \|  |  |  | \  ___/|  | \/|  \  ___/\  ___/ 
+/_______  /\____/|____/ |__|  (____  /\_/    \______  /___|  (____  /__|  |__|  \___  >__/\__|  |\___  >\___  >
+        \/                         \/               \/     \/     \/                \/   \______|    \/     \/ 
+
+ * Copyright (c) 2024 Sourav Chatterjee
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Test.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    std::uint64_t burnCpu(std::chrono::milliseconds duration)
+    {
+        std::uint64_t value = 1;
+        auto end = std::chrono::steady_clock::now() + duration;
+        while(std::chrono::steady_clock::now() < end)
+        {
+            for(int i = 0; i < 10000; ++i)
+            {
+                value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+            }
+            SouravTDD::doNotOptimize(value);
+        }
+        return value;
+    }
+
+    bool gArmBusyTest = false;
+}
+
+TEST("Test sampling profiler writes folded stacks")
+{
+#if SOURAVTDD_PROFILER
+    //Only one profiler runs at a time, so there is nothing to check when
+    //the whole run is being profiled with --profile.
+    if(SouravTDD::SamplingProfiler::running())
+    {
+        return;
+    }
+
+    SouravTDD::SamplingProfiler profiler(1000, 32);
+    CONFIRM_TRUE(profiler.start(1000));
+    SouravTDD::SamplingProfiler second(10, 8);
+    CHECK_FALSE(second.start(1000));
+    burnCpu(std::chrono::milliseconds(100));
+    profiler.stop();
+
+    CONFIRM_TRUE(profiler.sampleCount() > 0);
+    CONFIRM_TRUE(profiler.droppedCount() == 0);
+
+    std::size_t total = 0;
+    for(auto const & [stack, count] : profiler.foldedStacks())
+    {
+        CONFIRM_FALSE(stack.empty());
+        total += count;
+    }
+    CONFIRM_TRUE(total > 0);
+    CONFIRM_TRUE(total <= profiler.sampleCount());
+
+    std::string path = "souravtdd_profile_test.tmp";
+    CONFIRM_TRUE(profiler.writeFolded(path));
+    std::ifstream file(path);
+    std::string line;
+    std::size_t lines = 0;
+    while(std::getline(file, line))
+    {
+        ++lines;
+        CHECK_TRUE(line.find_last_of(' ') != std::string::npos);
+    }
+    file.close();
+    std::remove(path.c_str());
+    CONFIRM_TRUE(profiler.foldedStacks().size() == lines);
+#endif
+}
+
+TEST("Test busy test for profiling")
+{
+    if(gArmBusyTest)
+    {
+        burnCpu(std::chrono::milliseconds(100));
+    }
+}
+
+TEST("Test profile that cannot be written is reported")
+{
+#if SOURAVTDD_PROFILER
+    if(SouravTDD::SamplingProfiler::running())
+    {
+        return;
+    }
+
+    SouravTDD::Test* test = SouravTDD::findTest("Test busy test for profiling");
+    CONFIRM_TRUE(test != nullptr);
+    std::string blocker = "souravtdd_profile_blocker.tmp";
+    std::ofstream(blocker) << "not a directory";
+    SouravTDD::RunOptions options;
+    options.captureOutput = false;
+    options.profileDir = blocker + "/profiles";
+    std::ostringstream output;
+    int passed = 0;
+    int failed = 0;
+    int missedFailed = 0;
+    gArmBusyTest = true;
+    SouravTDD::runTest(output, test, passed, failed, missedFailed, options);
+    gArmBusyTest = false;
+    test->reset();
+    bool created = SouravTDD::makeDirectories(options.profileDir);
+    std::remove(blocker.c_str());
+
+    CONFIRM_FALSE(created);
+    CONFIRM_TRUE(output.str().find("Cannot write profile: " + options.profileDir + "/") != std::string::npos);
+#endif
+}
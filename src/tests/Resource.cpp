@@ -0,0 +1,66 @@
+/*
+  _________                                 _________ .__            __    __                 __               
+ /   _____/ ____  __ ______________ ___  __ \_   ___ \|  |__ _____ _/  |__/  |_  ___________ |__| ____   ____  
+ \_____  \ /  _ \|  |  \_  __ \__  \\  \/ / /    \  \/|  |  \\__  \\   __\   __\/ __ \_  __ \|  |/ __ \_/ __ \ 
+ /        (  <_> )  |  /|  | \// __ \\   /  \     \___|   Y  \/ __ \|  |  |  | \  ___/|  | \/|  \  ___/\  ___/ 
+/_______  /\____/|____/ |__|  (____  /\_/    \______  /___|  (____  /__|  |__|  \___  >__/\__|  |\___  >\___  >
+        \/                         \/               \/     \/     \/                \/   \______|    \/     \/ 
+
+ * Copyright (c) 2024 Sourav Chatterjee
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Test.h"
+#include <cstdio>
+#include <vector>
+
+TEST("Test resource snapshot counts open file descriptors")
+{
+    SouravTDD::ResourceSnapshot start;
+    std::FILE* file = std::tmpfile();
+    SouravTDD::ResourceUsage usage = SouravTDD::ResourceSnapshot().since(start);
+    std::fclose(file);
+#if SOURAVTDD_POSIX
+    CONFIRM(1L, usage.leakedFds);
+#endif
+    usage = SouravTDD::ResourceSnapshot().since(start);
+    CONFIRM(0L, usage.leakedFds);
+}
+
+TEST("Test resource snapshot counts page faults")
+{
+    SouravTDD::ResourceSnapshot start;
+    std::vector<char> buffer(16 * 1024 * 1024, 1);
+    SouravTDD::ResourceUsage usage = SouravTDD::ResourceSnapshot().since(start);
+#if SOURAVTDD_POSIX
+    CONFIRM_TRUE(usage.minorFaults > 0);
+#endif
+    CONFIRM_TRUE(usage.maxRssGrowthKb >= 0);
+}
+
+TEST("Test resource budget fails a leaking test")
+{
+    setExpectedFailureReason("Leaked 2 file descriptors.");
+    SouravTDD::RunOptions options;
+    options.failOnFdLeak = true;
+    SouravTDD::ResourceUsage usage;
+    usage.leakedFds = 2;
+    SouravTDD::checkResourceBudget(this, usage, options);
+}
@@ -0,0 +1,321 @@
+/*
+  _________                                 _________ .__            __    __                 __               
+ /   _____/ ____  __ ______________ ___  __ \_   ___ \|  |__ _____ _/  |__/  |_  ___________ |__| ____   ____  
+ \_____  \ /  _ \|  |  \_  __ \__  \\  \/ / /    \  \/|  |  \\__  \\   __\   __\/ __ \_  __ \|  |/ __ \_/ __ \ 
+ /        (  <_> )  |  /|  | \// __ \\   /  \     \___|   Y  \/ __ \|  |  |  | \  ___/|  | \/|  \  ___/\  ___/ 
+/_______  /\____/|____/ |__|  (____  /\_/    \______  /___|  (____  /__|  |__|  \___  >__/\__|  |\___  >\___  >
+        \/                         \/               \/     \/     \/                \/   \______|    \/     \/ 
+
+ * Copyright (c) 2024 Sourav Chatterjee
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Test.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+bool gSchemaCreated = false;
+
+class TempSchema
+{
+    public:
+        void setup()
+        {
+            //If this was real code, it might create the tables
+            //that the queries suite reads from.
+            gSchemaCreated = true;
+        }
+
+        void tearDown()
+        {
+        }
+};
+
+class TempConnection
+{
+    public:
+        void setup()
+        {
+            //If this was real code, it might open a connection
+            //to the database created by the schema suite.
+        }
+
+        void tearDown()
+        {
+        }
+};
+
+SouravTDD::TestSuiteSetupAndTearDown<TempSchema> gSchema("Test suite schema setup/teardown", "Schema");
+SouravTDD::TestSuiteSetupAndTearDown<TempConnection> gConnection("Test suite queries setup/teardown", "Queries");
+
+//Queries would run before Schema in name order.
+SUITE_DEPENDS_ON("Queries", "Schema")
+SUITE_RESOURCE("Queries", "Database")
+SUITE_RESOURCE("Schema", "Database")
+
+TEST_SUITE("Test schema exists", "Schema")
+{
+    CONFIRM_TRUE(gSchemaCreated);
+}
+
+TEST_SUITE("Test queries run after schema", "Queries")
+{
+    CONFIRM_TRUE(gSchemaCreated);
+}
+
+TEST("Test log queue keeps each producer's order")
+{
+    SouravTDD::LogQueue log;
+    int const producers = 4;
+    int const messages = 1000;
+    std::vector<std::thread> threads;
+    for(int producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([&log, producer]()
+        {
+            for(int i = 0; i < messages; ++i)
+            {
+                log.push(std::to_string(producer) + ":" + std::to_string(i));
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    std::string text;
+    while(received < producers * messages && log.waitPop(text))
+    {
+        auto colon = text.find(':');
+        int producer = std::stoi(text.substr(0, colon));
+        //Soft confirm so the producer threads are always joined.
+        CHECK(next[producer], std::stoi(text.substr(colon + 1)));
+        ++next[producer];
+        ++received;
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    CONFIRM(producers * messages, received);
+}
+
+TEST("Test shuffle order is a permutation that replays from its seed")
+{
+    std::vector<int> original {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    std::vector<int> first = original;
+    std::vector<int> second = original;
+    SouravTDD::shuffleOrder(first, 42);
+    SouravTDD::shuffleOrder(second, 42);
+    CONFIRM_TRUE(first == second);
+    CONFIRM_TRUE(std::is_permutation(first.begin(), first.end(), original.begin()));
+
+    std::vector<int> other = original;
+    SouravTDD::shuffleOrder(other, 43);
+    CONFIRM_TRUE(first != other);
+}
+
+namespace
+{
+    //The polluter only leaves state behind while a sequence test arms it,
+    //so both tests pass in a normal run.
+    bool gArmPolluter = false;
+    bool gPolluted = false;
+}
+
+TEST("Test sequence polluter")
+{
+    if(gArmPolluter)
+    {
+        gPolluted = true;
+    }
+}
+
+TEST("Test sequence victim")
+{
+    CONFIRM_FALSE(gPolluted);
+}
+
+TEST("Test sequence reports whether its last test failed")
+{
+    SouravTDD::Test* polluter = SouravTDD::findTest("Test sequence polluter");
+    SouravTDD::Test* victim = SouravTDD::findTest("Test sequence victim");
+    CONFIRM_TRUE(polluter != nullptr && victim != nullptr);
+
+    SouravTDD::RunOptions options;
+    options.captureOutput = false;
+    std::ostringstream output;
+    gArmPolluter = true;
+    gPolluted = false;
+    bool failedAfterPolluter = SouravTDD::runSequence(output, {polluter, victim}, options);
+    gPolluted = false;
+    bool failedAlone = SouravTDD::runSequence(output, {victim}, options);
+
+    std::string path = "souravtdd_sequence_test.tmp";
+    std::ofstream("souravtdd_sequence_test.tmp") << "Test sequence polluter\nTest sequence victim\n";
+    options.sequenceFile = path;
+    gPolluted = false;
+    int fileResult = SouravTDD::runSequenceFile(output, options);
+    std::ofstream("souravtdd_sequence_test.tmp") << "No such test\n";
+    int missingResult = SouravTDD::runSequenceFile(output, options);
+    std::remove(path.c_str());
+
+    gArmPolluter = false;
+    gPolluted = false;
+    polluter->reset();
+    victim->reset();
+    CONFIRM_TRUE(failedAfterPolluter);
+    CONFIRM_FALSE(failedAlone);
+    CONFIRM(1, fileResult);
+    CONFIRM(2, missingResult);
+}
+
+TEST("Test scheduler skips dependents of a failed setup")
+{
+    SouravTDD::SuiteScheduler scheduler({"Api", "Database", "Reports"},
+        {{"Api", {"Database"}}, {"Reports", {"Api"}}}, {});
+    std::size_t index = 0;
+    std::string skipReason;
+
+    CONFIRM_TRUE(scheduler.next(index, skipReason));
+    CONFIRM("Database", scheduler.getName(index));
+    CONFIRM("", skipReason);
+    scheduler.finish(index, false, false);
+
+    CONFIRM_TRUE(scheduler.next(index, skipReason));
+    CONFIRM("Api", scheduler.getName(index));
+    CONFIRM("Upstream suite Database setup failed.", skipReason);
+    scheduler.finish(index, false, true);
+
+    CONFIRM_TRUE(scheduler.next(index, skipReason));
+    CONFIRM("Reports", scheduler.getName(index));
+    CONFIRM("Upstream suite Api was skipped.", skipReason);
+    scheduler.finish(index, false, true);
+
+    CONFIRM_FALSE(scheduler.next(index, skipReason));
+}
+
+TEST("Test scheduler reports dependency cycles and unknown suites")
+{
+    SouravTDD::SuiteScheduler scheduler({"First", "Second", "Third"},
+        {{"First", {"Second"}}, {"Second", {"First"}}, {"Third", {"Missing"}}}, {});
+    std::size_t index = 0;
+    std::string skipReason;
+
+    CONFIRM_TRUE(scheduler.next(index, skipReason));
+    CONFIRM("Third", scheduler.getName(index));
+    CONFIRM("Depends on unknown suite Missing.", skipReason);
+    scheduler.finish(index, false, true);
+
+    CONFIRM_TRUE(scheduler.next(index, skipReason));
+    CONFIRM("First", scheduler.getName(index));
+    CONFIRM("Dependency cycle.", skipReason);
+    scheduler.finish(index, false, true);
+
+    CONFIRM_TRUE(scheduler.next(index, skipReason));
+    CONFIRM("Second", scheduler.getName(index));
+    CONFIRM("Upstream suite First was skipped.", skipReason);
+    scheduler.finish(index, false, true);
+
+    CONFIRM_FALSE(scheduler.next(index, skipReason));
+}
+
+TEST("Test scheduler holds a suite back while its resource is busy")
+{
+    SouravTDD::SuiteScheduler scheduler({"Reader", "Writer", "Other"}, {},
+        {{"Reader", {"Ports"}}, {"Writer", {"Ports"}}});
+    std::size_t reader = 0;
+    std::size_t other = 0;
+    std::size_t writer = 0;
+    std::string skipReason;
+
+    CONFIRM_TRUE(scheduler.next(reader, skipReason));
+    CONFIRM("Reader", scheduler.getName(reader));
+    CONFIRM_TRUE(scheduler.next(other, skipReason));
+    CONFIRM("Other", scheduler.getName(other));
+    scheduler.finish(reader, true, false);
+    CONFIRM_TRUE(scheduler.next(writer, skipReason));
+    CONFIRM("Writer", scheduler.getName(writer));
+    CONFIRM("", skipReason);
+    scheduler.finish(other, true, false);
+    scheduler.finish(writer, true, false);
+    CONFIRM_FALSE(scheduler.next(writer, skipReason));
+}
+
+TEST("Test scheduler never overlaps suites that share a resource")
+{
+    std::vector<std::string> names;
+    std::map<std::string, std::set<std::string>> resources;
+    for(int i = 0; i < 12; ++i)
+    {
+        names.push_back("Suite " + std::to_string(i));
+        if(i % 2 == 0)
+        {
+            resources[names.back()].insert("Database");
+        }
+    }
+    SouravTDD::SuiteScheduler scheduler(names, {}, resources);
+
+    std::atomic<int> holders = 0;
+    std::atomic<int> maxHolders = 0;
+    std::atomic<int> finished = 0;
+    std::vector<std::thread> threads;
+    for(int thread = 0; thread < 4; ++thread)
+    {
+        threads.emplace_back([&]()
+        {
+            std::size_t index = 0;
+            std::string skipReason;
+            while(scheduler.next(index, skipReason))
+            {
+                bool shared = resources.contains(scheduler.getName(index));
+                if(shared)
+                {
+                    int now = ++holders;
+                    int seen = maxHolders.load();
+                    while(now > seen && !maxHolders.compare_exchange_weak(seen, now))
+                    {
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                if(shared)
+                {
+                    --holders;
+                }
+                ++finished;
+                scheduler.finish(index, true, false);
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    CONFIRM(12, finished.load());
+    CONFIRM(1, maxHolders.load());
+}
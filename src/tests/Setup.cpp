@@ -45,7 +45,9 @@ void updateTestEntryName(int /*id*/, std::string_view name)
     {
         //If this was real code, it might throw an
         //exception because the name is empty.
+#if SOURAVTDD_EXCEPTIONS
         throw 1;
+#endif
     }
     //Real code would proceed to update the data with new name.
 }
@@ -121,6 +123,7 @@ class TempTable
 };
 
 
+#if SOURAVTDD_EXCEPTIONS
 TEST_EX("Test will run setup and teardown code", int)
 {
     SouravTDD::SetupAndTeardown<TempEntry> entry;
@@ -129,6 +132,7 @@ TEST_EX("Test will run setup and teardown code", int)
     //would be an int.
     updateTestEntryName(entry.getId(), "");
 }
+#endif
 
 SouravTDD::TestSuiteSetupAndTearDown<TempTable> gTable1("Test suite setup/teardown 1", "Suite 1");
 SouravTDD::TestSuiteSetupAndTearDown<TempTable> gTable2("Test suite setup/teardown 2", "Suite 1");
@@ -138,8 +142,10 @@ TEST_SUITE("Test part 1 of suite", "Suite 1")
     CONFIRM("test_data_01", gTable1.getTableName());
     CONFIRM("test_data_01", gTable2.getTableName());
 }
+#if SOURAVTDD_EXCEPTIONS
 TEST_SUITE_EX("Test part 2 of suite", "Suite 1", int)
 {
     //If this was a project test, it could use the table names from gTable1 and gTable2.
     throw 1;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
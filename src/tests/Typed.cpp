@@ -0,0 +1,133 @@
+/*
+  _________                                 _________ .__            __    __                 __               
+ /   _____/ ____  __ ______________ ___  __ \_   ___ \|  |__ _____ _/  |__/  |_  ___________ |__| ____   ____  
+ \_____  \ /  _ \|  |  \_  __ \__  \\  \/ / /    \  \/|  |  \\__  \\   __\   __\/ __ \_  __ \|  |/ __ \_/ __ \ 
+ /        (  <_> )  |  /|  | \// __ \\   /  \     \___|   Y  \/ __ \|  |  |  | \  ___/|  | \/|  \  ___/\  ___/ 
+/_______  /\____/|____/ |__|  (____  /\_/    \______  /___|  (____  /__|  |__|  \___  >__/\__|  |\___  >\___  >
+        \/                         \/               \/     \/     \/                \/   \______|    \/     \/ 
+
+ * Copyright (c) 2024 Sourav Chatterjee
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Test.h"
+#include <cstdint>
+#include <set>
+#include <span>
+#include <string>
+
+//16.16 fixed point. Multiplication drops the lowest bits, so results are
+//compared to within one unit in the last place.
+struct Fixed16
+{
+    std::int32_t raw;
+
+    static Fixed16 fromInt(int value) { return Fixed16{value * 65536}; }
+
+    Fixed16() : raw(0) {}
+    explicit Fixed16(std::int32_t rawValue) : raw(rawValue) {}
+
+    friend Fixed16 operator+(Fixed16 left, Fixed16 right) { return Fixed16{left.raw + right.raw}; }
+    friend Fixed16 operator*(Fixed16 left, Fixed16 right)
+    {
+        return Fixed16{static_cast<std::int32_t>((static_cast<std::int64_t>(left.raw) * right.raw) >> 16)};
+    }
+};
+
+template <>
+struct SouravTDD::ConfirmTraits<Fixed16>
+{
+    static bool equal(Fixed16 expected, Fixed16 actual)
+    {
+        return actual.raw - expected.raw <= 1 && expected.raw - actual.raw <= 1;
+    }
+
+    static std::string toString(Fixed16 value)
+    {
+        return std::to_string(value.raw / 65536.0);
+    }
+};
+
+template <>
+struct SouravTDD::TypeName<Fixed16>
+{
+    static std::string get() { return "Fixed16"; }
+};
+
+namespace
+{
+    template <typename T>
+    T makeValue(int value)
+    {
+        if constexpr (std::is_same_v<T, Fixed16>)
+        {
+            return Fixed16::fromInt(value);
+        }
+        else
+        {
+            return static_cast<T>(value);
+        }
+    }
+
+    template <typename T>
+    T dot(std::span<T const> left, std::span<T const> right)
+    {
+        T sum = makeValue<T>(0);
+        for(std::size_t i = 0; i < left.size(); ++i)
+        {
+            sum = sum + left[i] * right[i];
+        }
+        return sum;
+    }
+}
+
+TYPED_TEST("Test dot product kernel", TypeList<float, double, std::int32_t, std::int64_t, Fixed16>)
+{
+    TypeParam left[] = {makeValue<TypeParam>(1), makeValue<TypeParam>(2), makeValue<TypeParam>(3)};
+    TypeParam right[] = {makeValue<TypeParam>(4), makeValue<TypeParam>(5), makeValue<TypeParam>(6)};
+    CONFIRM(makeValue<TypeParam>(32), dot<TypeParam>(left, right));
+}
+
+TEST("Test typed tests register one test per type")
+{
+    std::set<std::string> names;
+    for(auto const * test : SouravTDD::getTests().at(""))
+    {
+        names.insert(std::string(test->getName()));
+    }
+    CONFIRM_TRUE(names.contains("Test dot product kernel<float>"));
+    CONFIRM_TRUE(names.contains("Test dot product kernel<double>"));
+    CONFIRM_TRUE(names.contains("Test dot product kernel<std::int32_t>"));
+    CONFIRM_TRUE(names.contains("Test dot product kernel<std::int64_t>"));
+    CONFIRM_TRUE(names.contains("Test dot product kernel<Fixed16>"));
+}
+
+TEST("Test confirm traits use the tolerance of each type")
+{
+    CONFIRM_TRUE(SouravTDD::ConfirmTraits<float>::equal(1.0f, 1.00005f));
+    CONFIRM_FALSE(SouravTDD::ConfirmTraits<double>::equal(1.0, 1.00005));
+    CONFIRM_FALSE(SouravTDD::ConfirmTraits<std::int64_t>::equal(1, 2));
+    CONFIRM_TRUE(SouravTDD::ConfirmTraits<Fixed16>::equal(Fixed16{100}, Fixed16{101}));
+    CONFIRM_FALSE(SouravTDD::ConfirmTraits<Fixed16>::equal(Fixed16{100}, Fixed16{102}));
+    CONFIRM("1.500000", SouravTDD::ConfirmTraits<Fixed16>::toString(Fixed16{98304}));
+
+    struct Unnamed {};
+    CONFIRM_TRUE(SouravTDD::TypeName<Unnamed>::get().find("Unnamed") != std::string::npos);
+}
@@ -30,7 +30,7 @@
 #include <iostream>
 #include "Test.h"
 
-int main()
+int main(int argc, char* argv[])
 {
-    return SouravTDD::runTests(std::cout);
+    return SouravTDD::runTests(std::cout, SouravTDD::parseRunOptions(argc, argv));
 }
\ No newline at end of file